@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/BCSR_Matrix.h"
+#include "include/arena.h"
+
+// Blocchi con kernel specializzati in calculus_bcsr.c
+const int bcsr_candidates[BCSR_NUM_CANDIDATES][2] = { {2, 2}, {3, 3}, {4, 4}, {6, 6} };
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static int compare_int(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Colonne di blocco distinte della riga di blocco br, in ordine crescente.
+ * stamp (NB elementi, per thread) evita di azzerare un marcatore per ogni
+ * riga di blocco: stamp[bc] == br + 1 indica la colonna già vista.
+ */
+static int collect_block_columns(const CSRMatrix* csr, int R, int C, int br, int* stamp, int* cols) {
+    int rb = br * R;
+    int re = rb + R < csr->M ? rb + R : csr->M;
+    int n = 0;
+    for (int i = rb; i < re; ++i) {
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            int bc = csr->JA[j] / C;
+            if (stamp[bc] != br + 1) {
+                stamp[bc] = br + 1;
+                cols[n++] = bc;
+            }
+        }
+    }
+    return n;
+}
+
+// Numero di blocchi per riga di blocco in block_count (MB elementi); restituisce NBZ
+static long long count_blocks(const CSRMatrix* csr, int R, int C, int* block_count) {
+    const int MB = (csr->M + R - 1) / R;
+    const int NB = (csr->N + C - 1) / C;
+    long long total = 0;
+
+    #pragma omp parallel reduction(+:total)
+    {
+        int* stamp = calloc((size_t)NB + 1, sizeof(int));
+        int* cols = malloc(((size_t)NB + 1) * sizeof(int));
+        safe_malloc_check(stamp, "calloc BCSR stamp");
+        safe_malloc_check(cols, "malloc BCSR cols");
+
+        #pragma omp for schedule(guided, 16)
+        for (int br = 0; br < MB; ++br) {
+            int n = collect_block_columns(csr, R, C, br, stamp, cols);
+            if (block_count) block_count[br] = n;
+            total += n;
+        }
+
+        free(stamp);
+        free(cols);
+    }
+    return total;
+}
+
+double bcsr_fill_ratio(const CSRMatrix* csr, int R, int C) {
+    if (csr->NZ == 0) return 1.0;
+    return (double)count_blocks(csr, R, C, NULL) * R * C / csr->NZ;
+}
+
+double detect_bcsr_block(const CSRMatrix* csr, int* R, int* C) {
+    // Byte per non-zero originale: valori (riempimento incluso) + un int per blocco;
+    // la CSR paga 8 + 4 byte
+    double best_cost = sizeof(double) + sizeof(int);
+    double best_fill = 1.0;
+    *R = 1;
+    *C = 1;
+
+    for (int k = 0; k < BCSR_NUM_CANDIDATES; ++k) {
+        int r = bcsr_candidates[k][0], c = bcsr_candidates[k][1];
+        double fill = bcsr_fill_ratio(csr, r, c);
+        double cost = fill * (sizeof(double) + (double)sizeof(int) / (r * c));
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_fill = fill;
+            *R = r;
+            *C = c;
+        }
+    }
+    return best_fill;
+}
+
+BCSRMatrix* convert_csr_to_bcsr(const CSRMatrix* csr, int R, int C) {
+    BCSRMatrix* mat = spmv_malloc(sizeof(BCSRMatrix));
+    safe_malloc_check(mat, "malloc BCSRMatrix");
+    mat->M = csr->M;
+    mat->N = csr->N;
+    mat->NZ = csr->NZ;
+    mat->R = R;
+    mat->C = C;
+    mat->MB = (csr->M + R - 1) / R;
+    mat->NB = (csr->N + C - 1) / C;
+
+    const int MB = mat->MB;
+    const int NB = mat->NB;
+    const int bs = R * C;
+
+    mat->IRP = spmv_malloc((MB + 1) * sizeof(int));
+    safe_malloc_check(mat->IRP, "malloc BCSR IRP");
+
+    // Primo passaggio: blocchi per riga di blocco e somma prefissa
+    mat->IRP[0] = 0;
+    count_blocks(csr, R, C, mat->IRP + 1);
+    for (int br = 0; br < MB; ++br) mat->IRP[br + 1] += mat->IRP[br];
+    mat->NBZ = mat->IRP[MB];
+
+    mat->JA = spmv_malloc((size_t)mat->NBZ * sizeof(int));
+    mat->AS = spmv_malloc((size_t)mat->NBZ * bs * sizeof(double));
+    safe_malloc_check(mat->JA, "malloc BCSR JA");
+    safe_malloc_check(mat->AS, "malloc BCSR AS");
+
+    // Secondo passaggio: colonne di blocco ordinate, poi scatter dei valori;
+    // stamp ricorda la posizione del blocco nella riga di blocco corrente
+    #pragma omp parallel
+    {
+        int* stamp = calloc((size_t)NB + 1, sizeof(int));
+        int* slot = malloc(((size_t)NB + 1) * sizeof(int));
+        safe_malloc_check(stamp, "calloc BCSR stamp");
+        safe_malloc_check(slot, "malloc BCSR slot");
+
+        #pragma omp for schedule(guided, 16)
+        for (int br = 0; br < MB; ++br) {
+            int first = mat->IRP[br];
+            int n = collect_block_columns(csr, R, C, br, stamp, mat->JA + first);
+            qsort(mat->JA + first, n, sizeof(int), compare_int);
+            for (int k = 0; k < n; ++k) slot[mat->JA[first + k]] = first + k;
+
+            memset(mat->AS + (size_t)first * bs, 0, (size_t)n * bs * sizeof(double));
+
+            int rb = br * R;
+            int re = rb + R < csr->M ? rb + R : csr->M;
+            for (int i = rb; i < re; ++i) {
+                for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+                    int c = csr->JA[j];
+                    double* block = mat->AS + (size_t)slot[c / C] * bs;
+                    block[(i - rb) * C + c % C] += csr->AS[j];
+                }
+            }
+        }
+
+        free(stamp);
+        free(slot);
+    }
+
+    return mat;
+}
+
+void free_bcsr_matrix(BCSRMatrix* mat) {
+    if (!mat) return;
+    spmv_free(mat->IRP);
+    spmv_free(mat->JA);
+    spmv_free(mat->AS);
+    spmv_free(mat);
+}
@@ -1,7 +1,15 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <omp.h>
 #include "include/CSR_Matrix.h"
 #include "include/mmio.h"
+#include "include/arena.h"
 
 static inline void safe_malloc_check(void* ptr, const char* msg) {
     if (!ptr) {
@@ -10,8 +18,330 @@ static inline void safe_malloc_check(void* ptr, const char* msg) {
     }
 }
 
-CSRMatrix* load_matrix_market_to_csr(const char* filename) {
-    
+// Potenze di 10 rappresentabili esattamente in double (fast path di Clinger)
+static const double exact_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline const char* skip_blanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p;
+}
+
+static inline const char* skip_line(const char* p, const char* end) {
+    while (p < end && *p != '\n') p++;
+    return p < end ? p + 1 : end;
+}
+
+static inline int is_token_end(const char* p, const char* end) {
+    return p >= end || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n';
+}
+
+// Parsing di un intero non negativo; restituisce NULL se il token non è valido
+static const char* parse_int(const char* p, const char* end, int* out) {
+    p = skip_blanks(p, end);
+    if (p >= end || *p < '0' || *p > '9') return NULL;
+
+    long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p - '0');
+        if (v > INT32_MAX) return NULL;
+        p++;
+    }
+    if (!is_token_end(p, end)) return NULL;
+
+    *out = (int)v;
+    return p;
+}
+
+// Parsing di un double: fast path esatto per mantisse <= 2^53 ed esponenti
+// in [-22, 22], altrimenti si ricade su strtod su una copia del token
+static const char* parse_double(const char* p, const char* end, double* out) {
+    p = skip_blanks(p, end);
+    const char* token = p;
+
+    int negative = 0;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0, exp10 = 0, seen_digit = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (mantissa || *p != '0') {
+            if (digits < 19) mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            else exp10++;
+            digits++;
+        }
+        seen_digit = 1;
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (mantissa || *p != '0') {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                    exp10--;
+                }
+                digits++;
+            } else {
+                exp10--;
+            }
+            seen_digit = 1;
+            p++;
+        }
+    }
+    if (seen_digit && p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        int exp_negative = 0;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_negative = (*p == '-');
+            p++;
+        }
+        int e = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (e < 100000) e = e * 10 + (*p - '0');
+            p++;
+        }
+        exp10 += exp_negative ? -e : e;
+    }
+
+    if (seen_digit && is_token_end(p, end) && digits <= 19 &&
+        mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+        double v = (double)mantissa;
+        v = exp10 < 0 ? v / exact_pow10[-exp10] : v * exact_pow10[exp10];
+        *out = negative ? -v : v;
+        return p;
+    }
+
+    // Fallback: il file mappato non è terminato da '\0', quindi si copia il token
+    char buf[128];
+    size_t len = 0;
+    p = token;
+    while (!is_token_end(p, end) && len < sizeof(buf) - 1) buf[len++] = *p++;
+    if (!is_token_end(p, end) || len == 0) return NULL;
+    buf[len] = '\0';
+
+    char* parsed_end;
+    *out = strtod(buf, &parsed_end);
+    if (parsed_end != buf + len) return NULL;
+    return p;
+}
+
+// Conta le righe contenenti un elemento (salta righe vuote e commenti)
+static long long count_entries(const char* p, const char* end) {
+    long long n = 0;
+    while (p < end) {
+        const char* q = skip_blanks(p, end);
+        if (q < end && *q != '\n' && *q != '%') n++;
+        p = skip_line(q, end);
+    }
+    return n;
+}
+
+/**
+ * Conversione COO -> CSR con counting sort parallelo.
+ *
+ * Le righe sono divise in nthreads intervalli contigui: ogni thread scorre
+ * tutti gli elementi COO ma conta e poi scrive solo quelli che cadono nelle
+ * proprie righe, così i conteggi vivono direttamente in IRP (O(M) memoria,
+ * senza istogrammi per thread) e lo scatter avviene senza atomiche e
+ * preserva l'ordine del file. Se `is_symmetric` è vero, ogni elemento
+ * fuori diagonale viene espanso anche nella posizione trasposta.
+ */
+static CSRMatrix* coo_to_csr_parallel(int M, int N, int nz, const int* rows,
+                                      const int* cols, const double* vals,
+                                      int is_symmetric) {
+    int nthreads = omp_get_max_threads();
+    if (nthreads > M) nthreads = M > 0 ? M : 1;
+
+    CSRMatrix* mat = spmv_malloc(sizeof(CSRMatrix));
+    safe_malloc_check(mat, "malloc CSRMatrix");
+    mat->M = M;
+    mat->N = N;
+    mat->IRP = spmv_malloc((M + 1) * sizeof(int));
+    safe_malloc_check(mat->IRP, "malloc IRP");
+
+    // Cursore di scrittura per riga, inizializzato da IRP dopo la somma prefissa
+    int* next = malloc(((size_t)M + 1) * sizeof(int));
+    safe_malloc_check(next, "malloc COO cursor");
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        const int tid = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+        const int r0 = (int)((long long)M * tid / nt);
+        const int r1 = (int)((long long)M * (tid + 1) / nt);
+        int* count = mat->IRP + 1;
+
+        for (int r = r0; r < r1; ++r) count[r] = 0;
+        for (int i = 0; i < nz; ++i) {
+            const int r = rows[i];
+            if (r >= r0 && r < r1) count[r]++;
+            if (is_symmetric) {
+                const int c = cols[i];
+                if (c != r && c >= r0 && c < r1) count[c]++;
+            }
+        }
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            mat->IRP[0] = 0;
+            for (int r = 0; r < M; ++r) mat->IRP[r + 1] += mat->IRP[r];
+
+            mat->NZ = mat->IRP[M];
+            mat->JA = spmv_malloc((size_t)mat->NZ * sizeof(int));
+            mat->AS = spmv_malloc((size_t)mat->NZ * sizeof(double));
+            safe_malloc_check(mat->JA, "malloc JA");
+            safe_malloc_check(mat->AS, "malloc AS");
+        }
+
+        for (int r = r0; r < r1; ++r) next[r] = mat->IRP[r];
+        for (int i = 0; i < nz; ++i) {
+            const int r = rows[i], c = cols[i];
+            if (r >= r0 && r < r1) {
+                const int idx = next[r]++;
+                mat->JA[idx] = c;
+                mat->AS[idx] = vals[i];
+            }
+            if (is_symmetric && c != r && c >= r0 && c < r1) {
+                const int idx = next[c]++;
+                mat->JA[idx] = r;
+                mat->AS[idx] = vals[i];
+            }
+        }
+    }
+
+    free(next);
+    return mat;
+}
+
+typedef struct {
+    int col;
+    int pos;                 // Posizione originale nella riga: rende l'ordinamento stabile
+} ColumnEntry;
+
+static int compare_column_entry(const void* a, const void* b) {
+    const ColumnEntry* ca = a;
+    const ColumnEntry* cb = b;
+    if (ca->col != cb->col) return (ca->col > cb->col) - (ca->col < cb->col);
+    return ca->pos - cb->pos;
+}
+
+/**
+ * Ordina le colonne di ogni riga e somma gli elementi (r, c) duplicati.
+ *
+ * Le righe sono indipendenti: ciascun thread ordina le proprie in un buffer
+ * privato (ordinamento stabile, quindi i duplicati si sommano nell'ordine
+ * del file) e ne registra la nuova lunghezza. Solo se qualche duplicato è
+ * stato fuso si ricalcola IRP e si compattano JA/AS sul posto.
+ */
+static void csr_sort_and_merge(CSRMatrix* mat) {
+    const int M = mat->M;
+
+    int max_len = 0;
+    #pragma omp parallel for schedule(static) reduction(max:max_len)
+    for (int i = 0; i < M; ++i) {
+        int len = mat->IRP[i + 1] - mat->IRP[i];
+        if (len > max_len) max_len = len;
+    }
+
+    int* row_len = malloc((M + 1) * sizeof(int));
+    safe_malloc_check(row_len, "malloc row_len");
+    long long merged = 0;
+
+    #pragma omp parallel reduction(+:merged)
+    {
+        ColumnEntry* entry = malloc((max_len + 1) * sizeof(ColumnEntry));
+        double* val = malloc((max_len + 1) * sizeof(double));
+        safe_malloc_check(entry, "malloc sort entries");
+        safe_malloc_check(val, "malloc sort values");
+
+        #pragma omp for schedule(guided, 64)
+        for (int i = 0; i < M; ++i) {
+            int* JA = mat->JA + mat->IRP[i];
+            double* AS = mat->AS + mat->IRP[i];
+            int len = mat->IRP[i + 1] - mat->IRP[i];
+
+            int sorted = 1;
+            for (int j = 1; j < len && sorted; ++j) sorted = JA[j - 1] < JA[j];
+            if (sorted) {
+                row_len[i] = len;
+                continue;
+            }
+
+            for (int j = 0; j < len; ++j) {
+                entry[j].col = JA[j];
+                entry[j].pos = j;
+                val[j] = AS[j];
+            }
+            qsort(entry, len, sizeof(ColumnEntry), compare_column_entry);
+
+            int out = -1;
+            for (int j = 0; j < len; ++j) {
+                if (out >= 0 && JA[out] == entry[j].col) {
+                    AS[out] += val[entry[j].pos];
+                } else {
+                    ++out;
+                    JA[out] = entry[j].col;
+                    AS[out] = val[entry[j].pos];
+                }
+            }
+            row_len[i] = out + 1;
+            merged += len - row_len[i];
+        }
+
+        free(entry);
+        free(val);
+    }
+
+    // Compattazione sul posto, riga per riga in ordine: la destinazione di
+    // ogni riga non supera la sua origine, quindi nessuna riga successiva
+    // viene sovrascritta prima di essere spostata
+    if (merged > 0) {
+        int dst = 0;
+        for (int i = 0; i < M; ++i) {
+            const int src = mat->IRP[i];
+            memmove(mat->JA + dst, mat->JA + src, (size_t)row_len[i] * sizeof(int));
+            memmove(mat->AS + dst, mat->AS + src, (size_t)row_len[i] * sizeof(double));
+            mat->IRP[i] = dst;
+            dst += row_len[i];
+        }
+        mat->IRP[M] = dst;
+        mat->NZ = dst;
+    }
+
+    free(row_len);
+}
+
+CSRMatrix* coo_to_csr(int M, int N, int nz, const int* rows, const int* cols,
+                      const double* vals, int is_symmetric) {
+    int invalid = 0;
+    #pragma omp parallel for schedule(static) reduction(+:invalid)
+    for (int k = 0; k < nz; ++k) {
+        if (rows[k] < 0 || rows[k] >= M || cols[k] < 0 || cols[k] >= N) invalid++;
+    }
+    if (invalid) {
+        printf("COO input: %d indici fuori dai limiti %d x %d\n", invalid, M, N);
+        return NULL;
+    }
+
+    CSRMatrix* mat = coo_to_csr_parallel(M, N, nz, rows, cols, vals, is_symmetric);
+    csr_sort_and_merge(mat);
+    return mat;
+}
+
+/**
+ * Loader comune. Con lower_only, per i file simmetrici ogni elemento viene
+ * riportato nel triangolo inferiore (riga >= colonna) senza espansione;
+ * *is_symmetric (se non NULL) riceve il flag del banner.
+ */
+static CSRMatrix* load_matrix_market(const char* filename, int lower_only, int* is_symmetric_out) {
+
     FILE* f = fopen(filename, "r");
     if (!f) {
         perror("Error opening file");
@@ -22,97 +352,189 @@ CSRMatrix* load_matrix_market_to_csr(const char* filename) {
     if (mm_read_banner(f, &matcode) != 0 ||
         !mm_is_matrix(matcode) ||
         !mm_is_coordinate(matcode) ||
-        (!mm_is_real(matcode) && !mm_is_pattern(matcode))) {
+        (!mm_is_real(matcode) && !mm_is_pattern(matcode) && !mm_is_integer(matcode))) {
         printf("Unsupported Matrix Market format\n");
         fclose(f);
         return NULL;
     }
 
     int M, N, NZ;
-    mm_read_mtx_crd_size(f, &M, &N, &NZ);
+    if (mm_read_mtx_crd_size(f, &M, &N, &NZ) != 0) {
+        printf("Could not read Matrix Market size line\n");
+        fclose(f);
+        return NULL;
+    }
+
+    // Il corpo del file inizia subito dopo la riga delle dimensioni
+    long body_offset = ftell(f);
+
+    struct stat st;
+    if (body_offset < 0 || fstat(fileno(f), &st) != 0) {
+        perror("Error reading file size");
+        fclose(f);
+        return NULL;
+    }
+
+    size_t file_size = (size_t)st.st_size;
+    char* map = NULL;
+    if (file_size > 0) {
+        map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+        if (map == MAP_FAILED) {
+            perror("Error mapping file");
+            fclose(f);
+            return NULL;
+        }
+        madvise(map, file_size, MADV_WILLNEED);
+    }
+    fclose(f);
 
     int is_pattern = mm_is_pattern(matcode);
     int is_symmetric = mm_is_symmetric(matcode);
+    int fold_lower = lower_only && is_symmetric;
+    if (is_symmetric_out) *is_symmetric_out = is_symmetric;
 
-    int capacity = is_symmetric ? 2 * NZ : NZ;
-
-    int* row_counts = calloc(M, sizeof(int));
-    int* rows = malloc(sizeof(int) * capacity);
-    int* cols = malloc(sizeof(int) * capacity);
-    double* vals = malloc(sizeof(double) * capacity);
-    safe_malloc_check(row_counts, "malloc row_counts");
+    int* rows = malloc(sizeof(int) * (size_t)NZ);
+    int* cols = malloc(sizeof(int) * (size_t)NZ);
+    double* vals = malloc(sizeof(double) * (size_t)NZ);
     safe_malloc_check(rows, "malloc rows");
     safe_malloc_check(cols, "malloc cols");
     safe_malloc_check(vals, "malloc vals");
 
-    int count = 0;
-    for (int i = 0; i < NZ; ++i) {
-        int r, c;
-        double v = 1.0;
-        if (is_pattern) {
-            fscanf(f, "%d %d", &r, &c);
-        } else {
-            fscanf(f, "%d %d %lf", &r, &c, &v);
-        }
-        r--; c--;
-        rows[count] = r;
-        cols[count] = c;
-        vals[count] = v;
-        row_counts[r]++;
-        count++;
-
-        if (is_symmetric && r != c) {
-            rows[count] = c;
-            cols[count] = r;
-            vals[count] = v;
-            row_counts[c]++;
-            count++;
-        }
+    // Suddivisione del corpo in chunk allineati a inizio riga, uno per thread
+    int nthreads = omp_get_max_threads();
+    const char* body = map + body_offset;
+    const char* body_end = map + file_size;
+    size_t body_size = (size_t)(body_end - body);
+
+    const char** bounds = malloc((nthreads + 1) * sizeof(char*));
+    long long* offsets = malloc((nthreads + 1) * sizeof(long long));
+    safe_malloc_check(bounds, "malloc bounds");
+    safe_malloc_check(offsets, "malloc offsets");
+
+    bounds[0] = body;
+    bounds[nthreads] = body_end;
+    for (int t = 1; t < nthreads; ++t) {
+        const char* p = body + body_size * t / nthreads;
+        if (p < bounds[t - 1]) p = bounds[t - 1];
+        if (p > body && p[-1] != '\n') p = skip_line(p, body_end);
+        bounds[t] = p;
     }
-    fclose(f);
 
-    CSRMatrix* mat = malloc(sizeof(CSRMatrix));
-    safe_malloc_check(mat, "malloc CSRMatrix");
+    int parse_error = 0;
 
-    mat->M = M;
-    mat->N = N;
-    mat->NZ = count;
-    mat->IRP = malloc((M + 1) * sizeof(int));
-    mat->JA = malloc(count * sizeof(int));
-    mat->AS = malloc(count * sizeof(double));
-    safe_malloc_check(mat->IRP, "malloc IRP");
-    safe_malloc_check(mat->JA, "malloc JA");
-    safe_malloc_check(mat->AS, "malloc AS");
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int tid = omp_get_thread_num();
+        offsets[tid + 1] = count_entries(bounds[tid], bounds[tid + 1]);
 
-    mat->IRP[0] = 0;
-    for (int i = 0; i < M; ++i) {
-        mat->IRP[i + 1] = mat->IRP[i] + row_counts[i];
+        #pragma omp barrier
+        #pragma omp single
+        {
+            offsets[0] = 0;
+            for (int t = 0; t < nthreads; ++t) offsets[t + 1] += offsets[t];
+        }
+
+        long long k = offsets[tid];
+        const char* p = bounds[tid];
+        const char* end = bounds[tid + 1];
+
+        while (p < end && k < NZ) {
+            const char* q = skip_blanks(p, end);
+            if (q >= end || *q == '\n' || *q == '%') {
+                p = skip_line(q, end);
+                continue;
+            }
+
+            int r, c;
+            double v = 1.0;
+            q = parse_int(q, end, &r);
+            if (q) q = parse_int(q, end, &c);
+            if (q && !is_pattern) q = parse_double(q, end, &v);
+
+            if (!q || r < 1 || r > M || c < 1 || c > N) {
+                #pragma omp atomic write
+                parse_error = 1;
+                break;
+            }
+
+            if (fold_lower && c > r) {
+                int t = r;
+                r = c;
+                c = t;
+            }
+            rows[k] = r - 1;
+            cols[k] = c - 1;
+            vals[k] = v;
+            k++;
+            p = skip_line(q, end);
+        }
     }
 
-    int* current_position = calloc(M, sizeof(int));
-    safe_malloc_check(current_position, "malloc current_position");
+    if (map) munmap(map, file_size);
 
-    for (int i = 0; i < count; ++i) {
-        int r = rows[i];
-        int idx = mat->IRP[r] + current_position[r];
-        mat->JA[idx] = cols[i];
-        mat->AS[idx] = vals[i];
-        current_position[r]++;
+    if (parse_error || offsets[nthreads] < NZ) {
+        printf(parse_error ? "Malformed entry in Matrix Market file\n"
+                           : "Premature end of Matrix Market file\n");
+        free(rows);
+        free(cols);
+        free(vals);
+        free(bounds);
+        free(offsets);
+        return NULL;
     }
 
+    // Gli indici sono già stati validati durante il parsing
+    CSRMatrix* mat = coo_to_csr_parallel(M, N, NZ, rows, cols, vals, is_symmetric && !fold_lower);
+    csr_sort_and_merge(mat);
+
     free(rows);
     free(cols);
     free(vals);
-    free(row_counts);
-    free(current_position);
+    free(bounds);
+    free(offsets);
 
     return mat;
 }
 
+CSRMatrix* load_matrix_market_to_csr(const char* filename) {
+    return load_matrix_market(filename, 0, NULL);
+}
+
+CSRMatrix* load_matrix_market_lower(const char* filename, int* is_symmetric) {
+    return load_matrix_market(filename, 1, is_symmetric);
+}
+
+int matrix_market_is_symmetric(const char* filename) {
+    FILE* f = fopen(filename, "r");
+    if (!f) return 0;
+
+    MM_typecode matcode;
+    int symmetric = mm_read_banner(f, &matcode) == 0 && mm_is_symmetric(matcode);
+    fclose(f);
+    return symmetric;
+}
+
+// Copia profonda con spmv_malloc: i buffer seguono l'arena corrente
+CSRMatrix* copy_csr_matrix(const CSRMatrix* csr) {
+    CSRMatrix* mat = spmv_malloc(sizeof(CSRMatrix));
+    safe_malloc_check(mat, "malloc CSRMatrix");
+    *mat = *csr;
+    mat->IRP = spmv_malloc((csr->M + 1) * sizeof(int));
+    mat->JA = spmv_malloc((size_t)csr->NZ * sizeof(int));
+    mat->AS = spmv_malloc((size_t)csr->NZ * sizeof(double));
+    safe_malloc_check(mat->IRP, "malloc IRP");
+    safe_malloc_check(mat->JA, "malloc JA");
+    safe_malloc_check(mat->AS, "malloc AS");
+    memcpy(mat->IRP, csr->IRP, (csr->M + 1) * sizeof(int));
+    memcpy(mat->JA, csr->JA, (size_t)csr->NZ * sizeof(int));
+    memcpy(mat->AS, csr->AS, (size_t)csr->NZ * sizeof(double));
+    return mat;
+}
+
 void free_csr_matrix(CSRMatrix* mat) {
     if (!mat) return;
-    free(mat->IRP);
-    free(mat->JA);
-    free(mat->AS);
-    free(mat);
-}
\ No newline at end of file
+    spmv_free(mat->IRP);
+    spmv_free(mat->JA);
+    spmv_free(mat->AS);
+    spmv_free(mat);
+}
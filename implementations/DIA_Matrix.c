@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/CSR_Matrix.h"
+#include "include/DIA_Matrix.h"
+#include "include/arena.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// occupied[off + M - 1] = 1 per ogni diagonale con almeno un elemento
+static char* mark_diagonals(const CSRMatrix* csr) {
+    const int M = csr->M;
+    char* occupied = calloc((size_t)M + csr->N, 1);
+    safe_malloc_check(occupied, "calloc DIA diagonals");
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < M; ++i) {
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            #pragma omp atomic write
+            occupied[csr->JA[j] - i + M - 1] = 1;
+        }
+    }
+    return occupied;
+}
+
+int count_dia_diagonals(const CSRMatrix* csr) {
+    char* occupied = mark_diagonals(csr);
+    int count = 0;
+    for (long long k = 0; k < (long long)csr->M + csr->N - 1; ++k) count += occupied[k];
+    free(occupied);
+    return count;
+}
+
+DIAMatrix* convert_csr_to_dia(const CSRMatrix* csr, double max_fill) {
+    const int M = csr->M;
+    const long long span = (long long)M + csr->N - 1;
+    char* occupied = mark_diagonals(csr);
+
+    int num_diags = 0;
+    for (long long k = 0; k < span; ++k) num_diags += occupied[k];
+
+    if (csr->NZ == 0 || (double)num_diags * M / csr->NZ > max_fill) {
+        free(occupied);
+        return NULL;
+    }
+
+    DIAMatrix* mat = spmv_malloc(sizeof(DIAMatrix));
+    safe_malloc_check(mat, "malloc DIAMatrix");
+    mat->M = M;
+    mat->N = csr->N;
+    mat->NZ = csr->NZ;
+    mat->num_diags = num_diags;
+    mat->offsets = spmv_malloc((num_diags + 1) * sizeof(int));
+    mat->data = spmv_malloc((size_t)num_diags * M * sizeof(double));
+    safe_malloc_check(mat->offsets, "malloc DIA offsets");
+    safe_malloc_check(mat->data, "malloc DIA data");
+
+    // Indice di diagonale per ogni offset occupato
+    int* diag_index = malloc(span * sizeof(int) + 1);
+    safe_malloc_check(diag_index, "malloc DIA index");
+    for (long long k = 0, d = 0; k < span; ++k) {
+        if (!occupied[k]) continue;
+        mat->offsets[d] = (int)(k - (M - 1));
+        diag_index[k] = (int)d++;
+    }
+    free(occupied);
+
+    // Zeri e scatter per righe: ogni thread tocca per primo le proprie righe
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < M; ++i) {
+        for (int d = 0; d < num_diags; ++d) mat->data[(size_t)d * M + i] = 0.0;
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            int d = diag_index[csr->JA[j] - i + M - 1];
+            mat->data[(size_t)d * M + i] += csr->AS[j];
+        }
+    }
+
+    free(diag_index);
+    return mat;
+}
+
+void free_dia_matrix(DIAMatrix* mat) {
+    if (!mat) return;
+    spmv_free(mat->offsets);
+    spmv_free(mat->data);
+    spmv_free(mat);
+}
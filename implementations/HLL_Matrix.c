@@ -1,9 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "include/CSR_Matrix.h"
 #include "include/HLL_Matrix.h"
-
-#define HACKSIZE 32
+#include "include/arena.h"
 
 static inline void safe_malloc_check(void* ptr, const char* msg) {
     if (!ptr) {
@@ -12,59 +12,111 @@ static inline void safe_malloc_check(void* ptr, const char* msg) {
     }
 }
 
-HLLMatrix* convert_csr_to_hll(const CSRMatrix* csr) {
+static void* aligned_malloc(size_t bytes, const char* msg) {
+    // spmv_malloc garantisce ARENA_ALIGNMENT (>= HLL_ALIGNMENT) byte
+    void* ptr = spmv_malloc(bytes);
+    safe_malloc_check(ptr, msg);
+    return ptr;
+}
+
+// Riga CSR memorizzata nella posizione r del formato (permutata in SELL-C-sigma)
+static inline int source_row(const int* perm, int r) {
+    return perm ? perm[r] : r;
+}
+
+/**
+ * Costruzione comune HLL / SELL-C-sigma: la riga r del formato è la riga
+ * perm[r] della matrice CSR (identità se perm == NULL). La matrice prende
+ * possesso di perm.
+ *
+ * I blocchi sono indipendenti: dimensioni in parallelo, un'unica somma
+ * prefissa su hack_offset, poi riempimento parallelo a schedulazione
+ * statica direttamente nelle posizioni finali, così ogni thread tocca per
+ * primo le pagine dei propri blocchi.
+ */
+static HLLMatrix* build_hll(const CSRMatrix* csr, int hack_size, int* perm) {
     int M = csr->M;
     int N = csr->N;
-    int num_blocks = (M + HACKSIZE - 1) / HACKSIZE;
+    int num_blocks = (M + hack_size - 1) / hack_size;
 
-    HLLMatrix* hll = malloc(sizeof(HLLMatrix));
+    HLLMatrix* hll = spmv_malloc(sizeof(HLLMatrix));
     safe_malloc_check(hll, "malloc HLLMatrix");
 
     hll->M = M;
     hll->N = N;
-    hll->HackSize = HACKSIZE;
+    hll->NZ = csr->NZ;
+    hll->HackSize = hack_size;
     hll->num_blocks = num_blocks;
-    hll->blocks = malloc(num_blocks * sizeof(HLLBlock));
+    hll->perm = perm;
+    hll->blocks = spmv_malloc((num_blocks + 1) * sizeof(HLLBlock));
+    hll->hack_offset = spmv_malloc((num_blocks + 1) * sizeof(int64_t));
     safe_malloc_check(hll->blocks, "malloc HLL blocks");
+    safe_malloc_check(hll->hack_offset, "malloc HLL hack_offset");
 
+    // Primo passaggio: dimensione di ogni blocco, poi offset nei buffer contigui
+    hll->hack_offset[0] = 0;
+    #pragma omp parallel for schedule(static)
     for (int b = 0; b < num_blocks; ++b) {
-        int start = b * HACKSIZE;
-        int end = (b + 1) * HACKSIZE;
+        int start = b * hack_size;
+        int end = (b + 1) * hack_size;
         if (end > M) end = M;
-        int rows_in_block = end - start;
 
         int max_nz = 0;
         for (int i = start; i < end; ++i) {
-            int nzr = csr->IRP[i + 1] - csr->IRP[i];
+            int r = source_row(perm, i);
+            int nzr = csr->IRP[r + 1] - csr->IRP[r];
             if (nzr > max_nz) max_nz = nzr;
         }
 
-        int size = rows_in_block * max_nz;
-        int* JA = malloc(size * sizeof(int));
-        double* AS = malloc(size * sizeof(double));
-        safe_malloc_check(JA, "malloc block JA");
-        safe_malloc_check(AS, "malloc block AS");
+        hll->blocks[b].rows_in_block = end - start;
+        hll->blocks[b].max_nz_per_row = max_nz;
+        hll->hack_offset[b + 1] = (int64_t)(end - start) * max_nz;
+    }
+    // I kernel indicizzano l'interno di un blocco con int: un solo blocco non può superarlo
+    for (int b = 0; b < num_blocks; ++b) {
+        if (hll->hack_offset[b + 1] > INT_MAX) {
+            fprintf(stderr, "HLL block %d too large: %lld padded entries\n", b, (long long)hll->hack_offset[b + 1]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int b = 0; b < num_blocks; ++b) hll->hack_offset[b + 1] += hll->hack_offset[b];
 
-        for (int i = 0; i < size; ++i) {
-            JA[i] = 0;
-            AS[i] = 0.0;
+    size_t total = (size_t)hll->hack_offset[num_blocks];
+    hll->JA = aligned_malloc(total * sizeof(int), "malloc HLL JA");
+    hll->AS = aligned_malloc(total * sizeof(double), "malloc HLL AS");
+
+    // Secondo passaggio: riempimento column-major, padding incluso
+    #pragma omp parallel for schedule(static)
+    for (int b = 0; b < num_blocks; ++b) {
+        int start = b * hack_size;
+        int rows_in_block = hll->blocks[b].rows_in_block;
+        int max_nz = hll->blocks[b].max_nz_per_row;
+        int* JA = hll->JA + hll->hack_offset[b];
+        double* AS = hll->AS + hll->hack_offset[b];
+
+        int row_start[rows_in_block];
+        int row_nz[rows_in_block];
+        for (int local_row = 0; local_row < rows_in_block; ++local_row) {
+            int r = source_row(perm, start + local_row);
+            row_start[local_row] = csr->IRP[r];
+            row_nz[local_row] = csr->IRP[r + 1] - csr->IRP[r];
         }
 
-        for (int i = start; i < end; ++i) {
-            int local_row = i - start;
-            int row_start = csr->IRP[i];
-            int row_end = csr->IRP[i + 1];
-            int nzr = row_end - row_start;
-
-            for (int j = 0; j < nzr; ++j) {
-                int idx = j * rows_in_block + local_row;
-                JA[idx] = csr->JA[row_start + j];
-                AS[idx] = csr->AS[row_start + j];
+        // Scrittura sequenziale nell'ordine di memoria (colonna ELLPACK per colonna)
+        for (int j = 0; j < max_nz; ++j) {
+            int* JA_col = JA + j * rows_in_block;
+            double* AS_col = AS + j * rows_in_block;
+            for (int local_row = 0; local_row < rows_in_block; ++local_row) {
+                if (j < row_nz[local_row]) {
+                    JA_col[local_row] = csr->JA[row_start[local_row] + j];
+                    AS_col[local_row] = csr->AS[row_start[local_row] + j];
+                } else {
+                    JA_col[local_row] = 0;
+                    AS_col[local_row] = 0.0;
+                }
             }
         }
 
-        hll->blocks[b].rows_in_block = rows_in_block;
-        hll->blocks[b].max_nz_per_row = max_nz;
         hll->blocks[b].JA = JA;
         hll->blocks[b].AS = AS;
     }
@@ -72,14 +124,216 @@ HLLMatrix* convert_csr_to_hll(const CSRMatrix* csr) {
     return hll;
 }
 
+HLLMatrix* convert_csr_to_hll(const CSRMatrix* csr, int hack_size) {
+    if (hack_size <= 0) hack_size = HLL_DEFAULT_HACKSIZE;
+    return build_hll(csr, hack_size, NULL);
+}
+
+typedef struct {
+    int len;
+    int row;
+} RowLength;
+
+// Ordine decrescente di lunghezza, a parità di lunghezza per indice di riga
+static int compare_row_length(const void* a, const void* b) {
+    const RowLength* ra = a;
+    const RowLength* rb = b;
+    if (ra->len != rb->len) return rb->len - ra->len;
+    return ra->row - rb->row;
+}
+
+// sigma viene arrotondato a un multiplo di hack_size, così ogni blocco
+// cade interamente in una finestra di ordinamento
+static int normalize_sigma(int sigma, int hack_size) {
+    if (sigma < hack_size) sigma = hack_size;
+    return (sigma + hack_size - 1) / hack_size * hack_size;
+}
+
+// Riempie perm (M elementi) con la permutazione SELL-C-sigma; sigma già normalizzato
+static void fill_sell_permutation(const CSRMatrix* csr, int sigma, int* perm) {
+    int M = csr->M;
+    int num_windows = (M + sigma - 1) / sigma;
+
+    // Le finestre si ordinano in modo indipendente, un buffer per thread
+    #pragma omp parallel
+    {
+        RowLength* window = malloc((sigma + 1) * sizeof(RowLength));
+        safe_malloc_check(window, "malloc SELL window");
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int k = 0; k < num_windows; ++k) {
+            int w = k * sigma;
+            int end = w + sigma < M ? w + sigma : M;
+            for (int i = w; i < end; ++i) {
+                window[i - w].len = csr->IRP[i + 1] - csr->IRP[i];
+                window[i - w].row = i;
+            }
+            qsort(window, end - w, sizeof(RowLength), compare_row_length);
+            for (int i = w; i < end; ++i) perm[i] = window[i - w].row;
+        }
+
+        free(window);
+    }
+}
+
+int* sell_row_permutation(const CSRMatrix* csr, int hack_size, int sigma) {
+    if (hack_size <= 0) hack_size = HLL_DEFAULT_HACKSIZE;
+
+    // Finisce in hll->perm, liberato da free_hll_matrix con spmv_free
+    int* perm = spmv_malloc((csr->M + 1) * sizeof(int));
+    safe_malloc_check(perm, "malloc SELL perm");
+    fill_sell_permutation(csr, normalize_sigma(sigma, hack_size), perm);
+    return perm;
+}
+
+HLLMatrix* convert_csr_to_sell(const CSRMatrix* csr, int hack_size, int sigma) {
+    if (hack_size <= 0) hack_size = HLL_DEFAULT_HACKSIZE;
+    return build_hll(csr, hack_size, sell_row_permutation(csr, hack_size, sigma));
+}
+
+double sell_padding_ratio(const CSRMatrix* csr, int hack_size, int sigma) {
+    if (hack_size <= 0) hack_size = HLL_DEFAULT_HACKSIZE;
+    // Permutazione usata solo per la stima: malloc, non l'arena che crescerebbe fino al reset
+    int* perm = NULL;
+    if (sigma > 0) {
+        perm = malloc((csr->M + 1) * sizeof(int));
+        safe_malloc_check(perm, "malloc SELL perm");
+        fill_sell_permutation(csr, normalize_sigma(sigma, hack_size), perm);
+    }
+
+    long long stored = 0;
+    for (int start = 0; start < csr->M; start += hack_size) {
+        int end = start + hack_size < csr->M ? start + hack_size : csr->M;
+        int max_nz = 0;
+        for (int i = start; i < end; ++i) {
+            int r = source_row(perm, i);
+            int nzr = csr->IRP[r + 1] - csr->IRP[r];
+            if (nzr > max_nz) max_nz = nzr;
+        }
+        stored += (long long)max_nz * (end - start);
+    }
+
+    free(perm);
+    return csr->NZ > 0 ? (double)stored / csr->NZ : 1.0;
+}
+
+double hll_padding_ratio(const HLLMatrix* hll) {
+    return hll->NZ > 0 ? (double)hll->hack_offset[hll->num_blocks] / hll->NZ : 1.0;
+}
+
+/**
+ * Cerca base[j] e uno stride comune tali che, per ogni slot j e riga locale i
+ * del blocco, JA[j * rows + i] == base[j] + i * stride sugli elementi
+ * memorizzati. Gli slot di padding (j >= row_len[i]) vengono ignorati,
+ * purché la colonna rigenerata resti in [0, N); gli zeri espliciti della
+ * matrice contano come elementi. Restituisce 1 se il blocco è codificabile;
+ * in tal caso scrive lo stride e le max_nz basi.
+ */
+static int detect_strided_block(const HLLMatrix* hll, int b, const int* row_len, int* stride_out, int* base) {
+    const int rows = hll->blocks[b].rows_in_block;
+    const int max_nz = hll->blocks[b].max_nz_per_row;
+    const int* JA = hll->JA + hll->hack_offset[b];
+
+    // Stride dai primi due elementi memorizzati della prima colonna ELLPACK
+    long long stride = 1;
+    int first = -1;
+    for (int i = 0; i < rows && max_nz > 0; ++i) {
+        if (row_len[i] == 0) continue;
+        if (first < 0) {
+            first = i;
+        } else {
+            long long dc = (long long)JA[i] - JA[first];
+            if (dc % (i - first) != 0) return 0;
+            stride = dc / (i - first);
+            break;
+        }
+    }
+
+    for (int j = 0; j < max_nz; ++j) {
+        const int* JA_col = JA + j * rows;
+        long long b_j = LLONG_MIN;
+
+        for (int i = 0; i < rows; ++i) {
+            if (j >= row_len[i]) continue;
+            long long expected = JA_col[i] - (long long)i * stride;
+            if (b_j == LLONG_MIN) b_j = expected;
+            else if (b_j != expected) return 0;
+        }
+        if (b_j == LLONG_MIN) b_j = stride >= 0 ? 0 : -(long long)(rows - 1) * stride;
+
+        long long last = b_j + (long long)(rows - 1) * stride;
+        if (b_j < 0 || b_j >= hll->N || last < 0 || last >= hll->N) return 0;
+        base[j] = (int)b_j;
+    }
+
+    *stride_out = (int)stride;
+    return 1;
+}
+
+HLLCompactIndex* hll_build_compact_index(const HLLMatrix* hll, const CSRMatrix* csr) {
+    const int num_blocks = hll->num_blocks;
+
+    HLLCompactIndex* index = spmv_malloc(sizeof(HLLCompactIndex));
+    safe_malloc_check(index, "malloc HLLCompactIndex");
+    index->num_blocks = num_blocks;
+    index->compact_blocks = 0;
+    index->desc = spmv_malloc((num_blocks + 1) * sizeof(HLLIndexDesc));
+    safe_malloc_check(index->desc, "malloc HLL index desc");
+
+    // Nel caso peggiore (nessun blocco compatto) lo stream coincide con JA:
+    // si costruisce in un buffer temporaneo e si copia alla lunghezza finale
+    int* data = malloc((size_t)hll->hack_offset[num_blocks] * sizeof(int) + 1);
+    int* row_len = malloc((hll->HackSize + 1) * sizeof(int));
+    safe_malloc_check(data, "malloc HLL index data");
+    safe_malloc_check(row_len, "malloc HLL index row_len");
+
+    long long len = 0;
+    for (int b = 0; b < num_blocks; ++b) {
+        const int size = (int)(hll->hack_offset[b + 1] - hll->hack_offset[b]);
+        int stride;
+
+        // Lunghezze delle righe memorizzate: distinguono il padding dagli zeri espliciti
+        for (int i = 0; i < hll->blocks[b].rows_in_block; ++i) {
+            int r = source_row(hll->perm, b * hll->HackSize + i);
+            row_len[i] = csr->IRP[r + 1] - csr->IRP[r];
+        }
+
+        index->desc[b].offset = len;
+        if (detect_strided_block(hll, b, row_len, &stride, data + len)) {
+            index->desc[b].stride = stride;
+            len += hll->blocks[b].max_nz_per_row;
+            index->compact_blocks++;
+        } else {
+            index->desc[b].stride = HLL_INDEX_FULL;
+            memcpy(data + len, hll->JA + hll->hack_offset[b], size * sizeof(int));
+            len += size;
+        }
+    }
+
+    index->data = spmv_malloc((size_t)len * sizeof(int));
+    safe_malloc_check(index->data, "malloc HLL index data");
+    memcpy(index->data, data, (size_t)len * sizeof(int));
+    index->data_len = len;
+    free(data);
+    free(row_len);
+    return index;
+}
+
+void free_hll_compact_index(HLLCompactIndex* index) {
+    if (!index) return;
+    spmv_free(index->desc);
+    spmv_free(index->data);
+    spmv_free(index);
+}
+
 void free_hll_matrix(HLLMatrix* mat) {
     if (!mat) return;
-    for (int b = 0; b < mat->num_blocks; ++b) {
-        free(mat->blocks[b].JA);
-        free(mat->blocks[b].AS);
-    }
-    free(mat->blocks);
-    free(mat);
+    spmv_free(mat->JA);
+    spmv_free(mat->AS);
+    spmv_free(mat->hack_offset);
+    spmv_free(mat->perm);
+    spmv_free(mat->blocks);
+    spmv_free(mat);
 }
 
 void print_hll_matrix(const HLLMatrix* mat) {
@@ -87,4 +341,4 @@ void print_hll_matrix(const HLLMatrix* mat) {
     for (int b = 0; b < mat->num_blocks; ++b) {
         printf("Block %d: rows = %d, max_nz = %d\n", b, mat->blocks[b].rows_in_block, mat->blocks[b].max_nz_per_row);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/CSR_Matrix.h"
+#include "include/HYB_Matrix.h"
+#include "include/arena.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+int hyb_select_ell_width(const CSRMatrix* csr) {
+    const int M = csr->M;
+    int max_len = 0;
+    for (int i = 0; i < M; ++i) {
+        int len = csr->IRP[i + 1] - csr->IRP[i];
+        if (len > max_len) max_len = len;
+    }
+
+    // Istogramma delle lunghezze, poi conteggio cumulativo dalle righe più lunghe
+    int* hist = calloc(max_len + 2, sizeof(int));
+    safe_malloc_check(hist, "calloc HYB histogram");
+    for (int i = 0; i < M; ++i) hist[csr->IRP[i + 1] - csr->IRP[i]]++;
+
+    int width = 0;
+    long long at_least = 0;
+    for (int k = max_len; k > 0; --k) {
+        at_least += hist[k];
+        if (3 * at_least >= M) {
+            width = k;
+            break;
+        }
+    }
+
+    free(hist);
+    return width;
+}
+
+HYBMatrix* convert_csr_to_hyb(const CSRMatrix* csr, int ell_width) {
+    const int M = csr->M;
+    if (ell_width <= 0) ell_width = hyb_select_ell_width(csr);
+
+    HYBMatrix* mat = spmv_malloc(sizeof(HYBMatrix));
+    safe_malloc_check(mat, "malloc HYBMatrix");
+    mat->M = M;
+    mat->N = csr->N;
+    mat->NZ = csr->NZ;
+    mat->ell_width = ell_width;
+    mat->ell_JA = spmv_malloc((size_t)ell_width * M * sizeof(int));
+    mat->ell_AS = spmv_malloc((size_t)ell_width * M * sizeof(double));
+    safe_malloc_check(mat->ell_JA, "malloc HYB ell_JA");
+    safe_malloc_check(mat->ell_AS, "malloc HYB ell_AS");
+
+    // Posizione di ogni riga nella coda COO: somma prefissa degli eccessi
+    int* coo_start = malloc((M + 1) * sizeof(int));
+    safe_malloc_check(coo_start, "malloc HYB coo_start");
+    coo_start[0] = 0;
+    for (int i = 0; i < M; ++i) {
+        int extra = csr->IRP[i + 1] - csr->IRP[i] - ell_width;
+        coo_start[i + 1] = coo_start[i] + (extra > 0 ? extra : 0);
+    }
+
+    mat->coo_nz = coo_start[M];
+    mat->coo_row = spmv_malloc((size_t)mat->coo_nz * sizeof(int));
+    mat->coo_col = spmv_malloc((size_t)mat->coo_nz * sizeof(int));
+    mat->coo_val = spmv_malloc((size_t)mat->coo_nz * sizeof(double));
+    safe_malloc_check(mat->coo_row, "malloc HYB coo_row");
+    safe_malloc_check(mat->coo_col, "malloc HYB coo_col");
+    safe_malloc_check(mat->coo_val, "malloc HYB coo_val");
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < M; ++i) {
+        int row_start = csr->IRP[i];
+        int len = csr->IRP[i + 1] - row_start;
+
+        for (int k = 0; k < ell_width; ++k) {
+            size_t idx = (size_t)k * M + i;
+            if (k < len) {
+                mat->ell_JA[idx] = csr->JA[row_start + k];
+                mat->ell_AS[idx] = csr->AS[row_start + k];
+            } else {
+                mat->ell_JA[idx] = 0;
+                mat->ell_AS[idx] = 0.0;
+            }
+        }
+
+        for (int k = ell_width, out = coo_start[i]; k < len; ++k, ++out) {
+            mat->coo_row[out] = i;
+            mat->coo_col[out] = csr->JA[row_start + k];
+            mat->coo_val[out] = csr->AS[row_start + k];
+        }
+    }
+
+    free(coo_start);
+    return mat;
+}
+
+void free_hyb_matrix(HYBMatrix* mat) {
+    if (!mat) return;
+    spmv_free(mat->ell_JA);
+    spmv_free(mat->ell_AS);
+    spmv_free(mat->coo_row);
+    spmv_free(mat->coo_col);
+    spmv_free(mat->coo_val);
+    spmv_free(mat);
+}
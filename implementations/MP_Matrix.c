@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/MP_Matrix.h"
+#include "include/arena.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static inline int fits_delta16(long long d) {
+    return d > DELTA16_ESCAPE && d <= DELTA16_MAX;
+}
+
+// Parole a 16 bit necessarie a codificare la riga i
+static int delta16_row_length(const CSRMatrix* csr, int i) {
+    int len = 0;
+    long long prev = i;
+    for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+        len += fits_delta16(csr->JA[j] - prev) ? 1 : 3;
+        prev = csr->JA[j];
+    }
+    return len;
+}
+
+CSRMatrixMP* convert_csr_to_mp(const CSRMatrix* csr, MPIndexMode index_mode) {
+    const int M = csr->M;
+
+    CSRMatrixMP* mat = spmv_malloc(sizeof(CSRMatrixMP));
+    safe_malloc_check(mat, "malloc CSRMatrixMP");
+    mat->M = M;
+    mat->N = csr->N;
+    mat->NZ = csr->NZ;
+    mat->index_mode = index_mode;
+    mat->JA = NULL;
+    mat->IDXP = NULL;
+    mat->JD = NULL;
+
+    mat->IRP = spmv_malloc((M + 1) * sizeof(int));
+    mat->AS = spmv_malloc((size_t)csr->NZ * sizeof(float));
+    safe_malloc_check(mat->IRP, "malloc MP IRP");
+    safe_malloc_check(mat->AS, "malloc MP AS");
+    memcpy(mat->IRP, csr->IRP, (M + 1) * sizeof(int));
+
+    #pragma omp parallel for schedule(static)
+    for (int j = 0; j < csr->NZ; ++j) mat->AS[j] = (float)csr->AS[j];
+
+    if (index_mode == MP_INDEX_INT32) {
+        mat->JA = spmv_malloc((size_t)csr->NZ * sizeof(int));
+        safe_malloc_check(mat->JA, "malloc MP JA");
+        memcpy(mat->JA, csr->JA, (size_t)csr->NZ * sizeof(int));
+        return mat;
+    }
+
+    // Stream di delta: lunghezza per riga, prefisso, poi codifica in parallelo
+    mat->IDXP = spmv_malloc((M + 1) * sizeof(int));
+    safe_malloc_check(mat->IDXP, "malloc MP IDXP");
+
+    mat->IDXP[0] = 0;
+    #pragma omp parallel for schedule(guided, 64)
+    for (int i = 0; i < M; ++i) mat->IDXP[i + 1] = delta16_row_length(csr, i);
+    for (int i = 0; i < M; ++i) mat->IDXP[i + 1] += mat->IDXP[i];
+
+    mat->JD = spmv_malloc((size_t)mat->IDXP[M] * sizeof(int16_t));
+    safe_malloc_check(mat->JD, "malloc MP JD");
+
+    #pragma omp parallel for schedule(guided, 64)
+    for (int i = 0; i < M; ++i) {
+        int16_t* out = mat->JD + mat->IDXP[i];
+        long long prev = i;
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            long long d = csr->JA[j] - prev;
+            if (fits_delta16(d)) {
+                *out++ = (int16_t)d;
+            } else {
+                uint32_t c = (uint32_t)csr->JA[j];
+                *out++ = DELTA16_ESCAPE;
+                *out++ = (int16_t)(uint16_t)(c >> 16);
+                *out++ = (int16_t)(uint16_t)(c & 0xFFFF);
+            }
+            prev = csr->JA[j];
+        }
+    }
+
+    return mat;
+}
+
+HLLMatrixMP* convert_hll_to_mp(const HLLMatrix* hll) {
+    const int num_blocks = hll->num_blocks;
+    const size_t total = (size_t)hll->hack_offset[num_blocks];
+
+    HLLMatrixMP* mat = spmv_malloc(sizeof(HLLMatrixMP));
+    safe_malloc_check(mat, "malloc HLLMatrixMP");
+    mat->M = hll->M;
+    mat->N = hll->N;
+    mat->NZ = hll->NZ;
+    mat->HackSize = hll->HackSize;
+    mat->num_blocks = num_blocks;
+    mat->perm = NULL;
+
+    mat->hack_offset = spmv_malloc((num_blocks + 1) * sizeof(int64_t));
+    mat->wide_offset = spmv_malloc((num_blocks + 1) * sizeof(int64_t));
+    mat->AS = spmv_malloc(total * sizeof(float));
+    safe_malloc_check(mat->hack_offset, "malloc MP hack_offset");
+    safe_malloc_check(mat->wide_offset, "malloc MP wide_offset");
+    safe_malloc_check(mat->AS, "malloc MP HLL AS");
+    memcpy(mat->hack_offset, hll->hack_offset, (num_blocks + 1) * sizeof(int64_t));
+
+    if (hll->perm) {
+        mat->perm = spmv_malloc(hll->M * sizeof(int));
+        safe_malloc_check(mat->perm, "malloc MP perm");
+        memcpy(mat->perm, hll->perm, hll->M * sizeof(int));
+    }
+
+    // Un blocco resta a 32 bit se anche un solo elemento non nullo ha
+    // |colonna - riga| fuori dal range int16; gli slot con valore zero
+    // (padding) possono puntare a qualunque colonna valida
+    mat->wide_offset[0] = 0;
+    for (int b = 0; b < num_blocks; ++b) {
+        const int rows = hll->blocks[b].rows_in_block;
+        const int size = rows * hll->blocks[b].max_nz_per_row;
+        const int* JA = hll->JA + hll->hack_offset[b];
+        const double* AS = hll->AS + hll->hack_offset[b];
+        int wide = 0;
+
+        for (int idx = 0; idx < size && !wide; ++idx) {
+            int row = b * hll->HackSize + idx % rows;
+            int col = AS[idx] != 0.0 ? JA[idx] : (row < hll->N ? row : hll->N - 1);
+            if (!fits_delta16((long long)col - row)) wide = 1;
+        }
+        mat->wide_offset[b + 1] = mat->wide_offset[b] + (wide ? size : 0);
+    }
+
+    // JD contiene solo i blocchi a 16 bit: quelli a 32 bit non hanno delta
+    const int64_t wide_total = mat->wide_offset[num_blocks];
+    mat->JA = spmv_malloc((size_t)wide_total * sizeof(int));
+    mat->JD = spmv_malloc((total - (size_t)wide_total) * sizeof(int16_t));
+    safe_malloc_check(mat->JA, "malloc MP HLL JA");
+    safe_malloc_check(mat->JD, "malloc MP HLL JD");
+
+    #pragma omp parallel for schedule(guided, 8)
+    for (int b = 0; b < num_blocks; ++b) {
+        const int rows = hll->blocks[b].rows_in_block;
+        const int size = rows * hll->blocks[b].max_nz_per_row;
+        const int* JA = hll->JA + hll->hack_offset[b];
+        const double* AS = hll->AS + hll->hack_offset[b];
+        const int wide = mat->wide_offset[b + 1] > mat->wide_offset[b];
+        int16_t* JD = mat->JD + (hll->hack_offset[b] - mat->wide_offset[b]);
+
+        for (int idx = 0; idx < size; ++idx) {
+            int row = b * hll->HackSize + idx % rows;
+            int col = AS[idx] != 0.0 ? JA[idx] : (row < hll->N ? row : hll->N - 1);
+            mat->AS[hll->hack_offset[b] + idx] = (float)AS[idx];
+            if (wide) mat->JA[mat->wide_offset[b] + idx] = col;
+            else JD[idx] = (int16_t)(col - row);
+        }
+    }
+
+    return mat;
+}
+
+void free_csr_mp_matrix(CSRMatrixMP* mat) {
+    if (!mat) return;
+    spmv_free(mat->IRP);
+    spmv_free(mat->AS);
+    spmv_free(mat->JA);
+    spmv_free(mat->IDXP);
+    spmv_free(mat->JD);
+    spmv_free(mat);
+}
+
+void free_hll_mp_matrix(HLLMatrixMP* mat) {
+    if (!mat) return;
+    spmv_free(mat->hack_offset);
+    spmv_free(mat->wide_offset);
+    spmv_free(mat->AS);
+    spmv_free(mat->JD);
+    spmv_free(mat->JA);
+    spmv_free(mat->perm);
+    spmv_free(mat);
+}
+
+double csr_mp_bytes_per_nz(const CSRMatrixMP* mat) {
+    if (mat->NZ == 0) return 0.0;
+    double bytes = (double)mat->NZ * sizeof(float);
+    if (mat->index_mode == MP_INDEX_INT32) bytes += (double)mat->NZ * sizeof(int);
+    else bytes += (double)mat->IDXP[mat->M] * sizeof(int16_t);
+    return bytes / mat->NZ;
+}
+
+double hll_mp_bytes_per_nz(const HLLMatrixMP* mat) {
+    if (mat->NZ == 0) return 0.0;
+    double slots = mat->hack_offset[mat->num_blocks];
+    double wide = mat->wide_offset[mat->num_blocks];
+    // JD copre solo i blocchi a 16 bit, JA solo quelli a 32 bit
+    double bytes = slots * sizeof(float) + (slots - wide) * sizeof(int16_t) + wide * sizeof(int);
+    return bytes / mat->NZ;
+}
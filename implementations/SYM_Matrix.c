@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/SYM_Matrix.h"
+#include "include/arena.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Primo indice di riga con IRP[r] >= target (ricerca binaria su IRP)
+static int row_at_nz(const CSRMatrix* csr, long long target) {
+    int lo = 0, hi = csr->M;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (csr->IRP[mid] < target) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static int compare_int(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Segmenti di riduzione: gli estremi di tutti i buffer non vuoti, ordinati,
+ * dividono le righe in intervalli coperti sempre dagli stessi thread. Al
+ * più 2 * nthreads estremi, quindi al più nthreads^2 coppie segmento-thread.
+ */
+static void build_reduction_segments(CSRSymMatrix* mat) {
+    const int T = mat->nthreads;
+    int* points = malloc((2 * T + 1) * sizeof(int));
+    safe_malloc_check(points, "malloc sym points");
+
+    int np = 0;
+    for (int t = 0; t < T; ++t) {
+        if (mat->partial_lo[t] >= mat->row_start[t]) continue;
+        points[np++] = mat->partial_lo[t];
+        points[np++] = mat->row_start[t];
+    }
+    qsort(points, np, sizeof(int), compare_int);
+    int unique = 0;
+    for (int k = 0; k < np; ++k) {
+        if (unique == 0 || points[k] != points[unique - 1]) points[unique++] = points[k];
+    }
+
+    const int nseg = unique > 1 ? unique - 1 : 0;
+    mat->num_segments = nseg;
+    mat->segment_bounds = spmv_malloc((nseg + 1) * sizeof(int));
+    mat->segment_ptr = spmv_malloc((nseg + 1) * sizeof(int));
+    mat->segment_threads = spmv_malloc(((size_t)nseg * T + 1) * sizeof(int));
+    safe_malloc_check(mat->segment_bounds, "malloc sym segment_bounds");
+    safe_malloc_check(mat->segment_ptr, "malloc sym segment_ptr");
+    safe_malloc_check(mat->segment_threads, "malloc sym segment_threads");
+
+    int count = 0;
+    mat->segment_ptr[0] = 0;
+    mat->segment_bounds[0] = unique > 0 ? points[0] : 0;
+    for (int k = 0; k < nseg; ++k) {
+        mat->segment_bounds[k + 1] = points[k + 1];
+        for (int t = 0; t < T; ++t) {
+            if (mat->partial_lo[t] <= points[k] && points[k + 1] <= mat->row_start[t]) {
+                mat->segment_threads[count++] = t;
+            }
+        }
+        mat->segment_ptr[k + 1] = count;
+    }
+    free(points);
+}
+
+CSRSymMatrix* build_sym_matrix(CSRMatrix* lower, int nthreads) {
+    if (nthreads <= 0) nthreads = omp_get_max_threads();
+
+    CSRSymMatrix* mat = spmv_malloc(sizeof(CSRSymMatrix));
+    safe_malloc_check(mat, "malloc CSRSymMatrix");
+    mat->lower = *lower;
+    mat->nthreads = nthreads;
+    mat->row_start = spmv_malloc((nthreads + 1) * sizeof(int));
+    mat->partial_offset = spmv_malloc((nthreads + 1) * sizeof(long long));
+    safe_malloc_check(mat->row_start, "malloc sym row_start");
+    safe_malloc_check(mat->partial_offset, "malloc sym partial_offset");
+    // La struttura è stata copiata: si libera solo il contenitore
+    spmv_free(lower);
+
+    // Righe bilanciate sui non-zero memorizzati (ognuno vale due aggiornamenti)
+    mat->row_start[0] = 0;
+    for (int t = 1; t < nthreads; ++t) {
+        int r = row_at_nz(&mat->lower, (long long)mat->lower.NZ * t / nthreads);
+        mat->row_start[t] = r > mat->row_start[t - 1] ? r : mat->row_start[t - 1];
+    }
+    mat->row_start[nthreads] = mat->lower.M;
+
+    // Colonna minima toccata da ogni thread: il buffer privato parte da lì
+    mat->partial_lo = spmv_malloc(nthreads * sizeof(int));
+    safe_malloc_check(mat->partial_lo, "malloc sym partial_lo");
+    #pragma omp parallel for schedule(static, 1)
+    for (int t = 0; t < nthreads; ++t) {
+        int lo = mat->row_start[t];
+        const int* IRP = mat->lower.IRP;
+        for (int i = mat->row_start[t]; i < mat->row_start[t + 1]; ++i) {
+            for (int j = IRP[i]; j < IRP[i + 1]; ++j) {
+                if (mat->lower.JA[j] < lo) lo = mat->lower.JA[j];
+            }
+        }
+        mat->partial_lo[t] = lo;
+    }
+
+    mat->partial_offset[0] = 0;
+    for (int t = 0; t < nthreads; ++t) {
+        mat->partial_offset[t + 1] = mat->partial_offset[t] + mat->row_start[t] - mat->partial_lo[t];
+    }
+    mat->partial = spmv_malloc((size_t)mat->partial_offset[nthreads] * sizeof(double));
+    safe_malloc_check(mat->partial, "malloc sym partial");
+
+    build_reduction_segments(mat);
+    return mat;
+}
+
+CSRSymMatrix* convert_csr_to_sym(const CSRMatrix* csr, int nthreads) {
+    if (csr->M != csr->N) {
+        printf("Formato simmetrico: matrice non quadrata (%d x %d)\n", csr->M, csr->N);
+        return NULL;
+    }
+
+    const int M = csr->M;
+    CSRMatrix* lower = spmv_malloc(sizeof(CSRMatrix));
+    safe_malloc_check(lower, "malloc CSRMatrix");
+    lower->M = M;
+    lower->N = M;
+    lower->IRP = spmv_malloc((M + 1) * sizeof(int));
+    safe_malloc_check(lower->IRP, "malloc sym IRP");
+
+    lower->IRP[0] = 0;
+    #pragma omp parallel for schedule(guided, 64)
+    for (int i = 0; i < M; ++i) {
+        int count = 0;
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) count += csr->JA[j] <= i;
+        lower->IRP[i + 1] = count;
+    }
+    for (int i = 0; i < M; ++i) lower->IRP[i + 1] += lower->IRP[i];
+
+    lower->NZ = lower->IRP[M];
+    lower->JA = spmv_malloc((size_t)lower->NZ * sizeof(int));
+    lower->AS = spmv_malloc((size_t)lower->NZ * sizeof(double));
+    safe_malloc_check(lower->JA, "malloc sym JA");
+    safe_malloc_check(lower->AS, "malloc sym AS");
+
+    #pragma omp parallel for schedule(guided, 64)
+    for (int i = 0; i < M; ++i) {
+        int out = lower->IRP[i];
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            if (csr->JA[j] > i) continue;
+            lower->JA[out] = csr->JA[j];
+            lower->AS[out] = csr->AS[j];
+            out++;
+        }
+    }
+
+    return build_sym_matrix(lower, nthreads);
+}
+
+CSRSymMatrix* load_matrix_market_to_sym(const char* filename, int nthreads) {
+    int is_symmetric = 0;
+    CSRMatrix* lower = load_matrix_market_lower(filename, &is_symmetric);
+    if (!lower) return NULL;
+    if (!is_symmetric) {
+        free_csr_matrix(lower);
+        return NULL;
+    }
+    return build_sym_matrix(lower, nthreads);
+}
+
+void free_sym_matrix(CSRSymMatrix* mat) {
+    if (!mat) return;
+    spmv_free(mat->lower.IRP);
+    spmv_free(mat->lower.JA);
+    spmv_free(mat->lower.AS);
+    spmv_free(mat->partial);
+    spmv_free(mat->row_start);
+    spmv_free(mat->partial_lo);
+    spmv_free(mat->partial_offset);
+    spmv_free(mat->segment_bounds);
+    spmv_free(mat->segment_ptr);
+    spmv_free(mat->segment_threads);
+    spmv_free(mat);
+}
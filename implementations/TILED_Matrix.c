@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/TILED_Matrix.h"
+#include "include/cache_info.h"
+#include "include/arena.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Primo indice di riga con IRP[r] >= target (ricerca binaria su IRP)
+static int row_at_nz(const CSRMatrix* csr, long long target) {
+    int lo = 0, hi = csr->M;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (csr->IRP[mid] < target) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+int tiled_panel_width(size_t llc_bytes) {
+    size_t width = (size_t)(llc_bytes * TILED_LLC_FRACTION) / sizeof(double);
+    // Multiplo di una linea di cache di x (8 double)
+    width &= ~(size_t)7;
+    if (width < TILED_MIN_PANEL_WIDTH) width = TILED_MIN_PANEL_WIDTH;
+    if (width > (size_t)1 << 30) width = (size_t)1 << 30;
+    return (int)width;
+}
+
+CSRTiledMatrix* convert_csr_to_tiled(const CSRMatrix* csr, int panel_width, int nthreads) {
+    if (panel_width <= 0) panel_width = tiled_panel_width(detect_llc_size());
+    if (nthreads <= 0) nthreads = omp_get_max_threads();
+
+    const int M = csr->M;
+    const int P = csr->N > 0 ? (int)(((long long)csr->N + panel_width - 1) / panel_width) : 1;
+    const int T = nthreads;
+    if ((long long)P * M > (long long)TILED_MAX_PANEL_RATIO * csr->NZ) return NULL;
+
+    CSRTiledMatrix* mat = spmv_malloc(sizeof(CSRTiledMatrix));
+    safe_malloc_check(mat, "malloc CSRTiledMatrix");
+    mat->M = M;
+    mat->N = csr->N;
+    mat->NZ = csr->NZ;
+    mat->panel_width = panel_width;
+    mat->num_panels = P;
+    mat->nthreads = T;
+    mat->panel_ptr = spmv_malloc(((size_t)P * T + 1) * sizeof(int));
+    mat->JA = spmv_malloc((size_t)csr->NZ * sizeof(int));
+    mat->AS = spmv_malloc((size_t)csr->NZ * sizeof(double));
+    mat->row_start = spmv_malloc((T + 1) * sizeof(int));
+    safe_malloc_check(mat->panel_ptr, "malloc tiled panel_ptr");
+    safe_malloc_check(mat->JA, "malloc tiled JA");
+    safe_malloc_check(mat->AS, "malloc tiled AS");
+    safe_malloc_check(mat->row_start, "malloc tiled row_start");
+
+    // Righe dei thread bilanciate sui non-zero, come per la CSR simmetrica
+    mat->row_start[0] = 0;
+    for (int t = 1; t < T; ++t) {
+        int r = row_at_nz(csr, (long long)csr->NZ * t / T);
+        mat->row_start[t] = r > mat->row_start[t - 1] ? r : mat->row_start[t - 1];
+    }
+    mat->row_start[T] = M;
+
+    // Non-zero e righe non vuote per (pannello, thread), in ordine p * T + t:
+    // è lo stesso ordine in cui i blocchi vengono memorizzati
+    int* nz_off = calloc((size_t)P * T + 1, sizeof(int));
+    safe_malloc_check(nz_off, "calloc tiled nz_off");
+    int* rows_off = mat->panel_ptr;
+    for (size_t k = 0; k <= (size_t)P * T; ++k) rows_off[k] = 0;
+
+    #pragma omp parallel num_threads(T)
+    {
+        int* last_row = malloc(P * sizeof(int));
+        safe_malloc_check(last_row, "malloc tiled last_row");
+
+        for (int t = omp_get_thread_num(); t < T; t += omp_get_num_threads()) {
+            for (int p = 0; p < P; ++p) last_row[p] = -1;
+            for (int i = mat->row_start[t]; i < mat->row_start[t + 1]; ++i) {
+                for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+                    const int p = csr->JA[j] / panel_width;
+                    nz_off[(size_t)p * T + t + 1]++;
+                    if (last_row[p] != i) {
+                        last_row[p] = i;
+                        rows_off[(size_t)p * T + t + 1]++;
+                    }
+                }
+            }
+        }
+        free(last_row);
+    }
+
+    for (size_t k = 0; k < (size_t)P * T; ++k) {
+        nz_off[k + 1] += nz_off[k];
+        rows_off[k + 1] += rows_off[k];
+    }
+    const int num_rows = rows_off[(size_t)P * T];
+    mat->num_rows = num_rows;
+    mat->row_idx = spmv_malloc(((size_t)num_rows + 1) * sizeof(int));
+    mat->row_ptr = spmv_malloc(((size_t)num_rows + 1) * sizeof(int));
+    safe_malloc_check(mat->row_idx, "malloc tiled row_idx");
+    safe_malloc_check(mat->row_ptr, "malloc tiled row_ptr");
+
+    // Dispersione: ogni thread scorre le sue righe in ordine e riempie i propri blocchi
+    #pragma omp parallel num_threads(T)
+    {
+        int* next_nz = malloc(P * sizeof(int));
+        int* next_row = malloc(P * sizeof(int));
+        safe_malloc_check(next_nz, "malloc tiled next_nz");
+        safe_malloc_check(next_row, "malloc tiled next_row");
+
+        for (int t = omp_get_thread_num(); t < T; t += omp_get_num_threads()) {
+            for (int p = 0; p < P; ++p) {
+                next_nz[p] = nz_off[(size_t)p * T + t];
+                next_row[p] = mat->panel_ptr[(size_t)p * T + t];
+            }
+            for (int i = mat->row_start[t]; i < mat->row_start[t + 1]; ++i) {
+                for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+                    const int p = csr->JA[j] / panel_width;
+                    // Prima occorrenza della riga i nel pannello p
+                    const int k = next_row[p];
+                    if (k == mat->panel_ptr[(size_t)p * T + t] || mat->row_idx[k - 1] != i) {
+                        mat->row_idx[k] = i;
+                        mat->row_ptr[k] = next_nz[p];
+                        next_row[p]++;
+                    }
+                    const int out = next_nz[p]++;
+                    mat->JA[out] = csr->JA[j];
+                    mat->AS[out] = csr->AS[j];
+                }
+            }
+        }
+        free(next_nz);
+        free(next_row);
+    }
+    mat->row_ptr[num_rows] = csr->NZ;
+
+    free(nz_off);
+    return mat;
+}
+
+void free_tiled_matrix(CSRTiledMatrix* mat) {
+    if (!mat) return;
+    spmv_free(mat->panel_ptr);
+    spmv_free(mat->row_idx);
+    spmv_free(mat->row_ptr);
+    spmv_free(mat->JA);
+    spmv_free(mat->AS);
+    spmv_free(mat->row_start);
+    spmv_free(mat);
+}
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/spmv_plan.h"
+#include "include/autotune.h"
+#include "include/arena.h"
+
+#define TUNE_LINE_LENGTH 1024
+
+// HackSize candidati: multipli della larghezza SIMD (4 double AVX2, 8 AVX-512)
+static const int autotune_hacksizes[] = { 8, 16, 32, 64, 128, 256 };
+#define AUTOTUNE_NUM_HACKSIZES ((int)(sizeof(autotune_hacksizes) / sizeof(autotune_hacksizes[0])))
+
+int autotune_hacksize(const CSRMatrix* csr, int nthreads, double* best_time) {
+    double* x = malloc(csr->N * sizeof(double) + 1);
+    double* y = malloc(csr->M * sizeof(double) + 1);
+    if (!x || !y) {
+        perror("malloc autotune vectors");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < csr->N; i++) x[i] = 1.0;
+
+    int best = HLL_DEFAULT_HACKSIZE;
+    double best_t = -1.0;
+
+    // Le matrici di prova non vanno nell'arena corrente: verrebbero liberate
+    // solo al reset, moltiplicando l'occupazione per il numero di candidati
+    Arena* arena = spmv_get_arena();
+    spmv_set_arena(NULL);
+
+    for (int k = 0; k < AUTOTUNE_NUM_HACKSIZES; k++) {
+        int hack_size = autotune_hacksizes[k];
+        HLLMatrix* hll = convert_csr_to_hll(csr, hack_size);
+        spmv_plan_t* plan = spmv_plan_create(hll, SPMV_FORMAT_HLL, nthreads);
+
+        // Una esecuzione di riscaldamento, poi il minimo su più ripetizioni
+        spmv_plan_execute(plan, x, y);
+        double t_min = -1.0;
+        for (int r = 0; r < AUTOTUNE_REPETITIONS; r++) {
+            double start = omp_get_wtime();
+            spmv_plan_execute(plan, x, y);
+            double t = omp_get_wtime() - start;
+            if (t_min < 0.0 || t < t_min) t_min = t;
+        }
+
+        printf("  HackSize %3d: %.6lf s (padding %.3f)\n", hack_size, t_min, hll_padding_ratio(hll));
+
+        if (best_t < 0.0 || t_min < best_t) {
+            best_t = t_min;
+            best = hack_size;
+        }
+
+        spmv_plan_destroy(plan);
+        free_hll_matrix(hll);
+    }
+    spmv_set_arena(arena);
+
+    free(x);
+    free(y);
+    if (best_time) *best_time = best_t;
+    return best;
+}
+
+int load_tuned_hacksize(const char* tune_path, const char* matrix_name) {
+    FILE* f = fopen(tune_path, "r");
+    if (!f) return 0;
+
+    char line[TUNE_LINE_LENGTH];
+    char name[TUNE_LINE_LENGTH];
+    int hack_size = 0, value;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%1023s %d", name, &value) == 2 && strcmp(name, matrix_name) == 0) {
+            hack_size = value;
+        }
+    }
+
+    fclose(f);
+    return hack_size;
+}
+
+int store_tuned_hacksize(const char* tune_path, const char* matrix_name, int hack_size, double time) {
+    size_t tmp_len = strlen(tune_path) + 5;
+    char* tmp_path = malloc(tmp_len);
+    if (!tmp_path) {
+        perror("malloc tune path");
+        return -1;
+    }
+    snprintf(tmp_path, tmp_len, "%s.tmp", tune_path);
+
+    FILE* out = fopen(tmp_path, "w");
+    if (!out) {
+        perror("Error creating tuning file");
+        free(tmp_path);
+        return -1;
+    }
+
+    // Copia le voci delle altre matrici e sostituisce quella corrente
+    FILE* in = fopen(tune_path, "r");
+    if (in) {
+        char line[TUNE_LINE_LENGTH];
+        char name[TUNE_LINE_LENGTH];
+        while (fgets(line, sizeof(line), in)) {
+            if (sscanf(line, "%1023s", name) == 1 && strcmp(name, matrix_name) == 0) continue;
+            fputs(line, out);
+        }
+        fclose(in);
+    }
+    fprintf(out, "%s %d %.9lf\n", matrix_name, hack_size, time);
+
+    int err = fclose(out) != 0;
+    if (!err && rename(tmp_path, tune_path) != 0) err = 1;
+    if (err) {
+        perror("Error writing tuning file");
+        remove(tmp_path);
+    }
+
+    free(tmp_path);
+    return err ? -1 : 0;
+}
@@ -1,7 +1,14 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <omp.h>
 #include "include/CSR_Matrix.h"
 #include "include/HLL_Matrix.h"
+#include "include/partition.h"
+#include "include/MP_Matrix.h"
+#include "include/SYM_Matrix.h"
+#include "include/DIA_Matrix.h"
+#include "include/HYB_Matrix.h"
+#include "include/TILED_Matrix.h"
 
 void csr_serial_mat_per_vec(CSRMatrix *csr_matrix, double *x, double *y){
     for (int i = 0; i < csr_matrix->M; i++) {
@@ -14,25 +21,27 @@ void csr_serial_mat_per_vec(CSRMatrix *csr_matrix, double *x, double *y){
 }
 
 void hll_serial_mat_per_vec(HLLMatrix *hll_matrix, const double *x, double *y) {
-    int global_row_offset = 0;
+    const int HackSize = hll_matrix->HackSize;
+    const int *perm = hll_matrix->perm;
 
     for (int b = 0; b < hll_matrix->num_blocks; b++) {
-        HLLBlock block = hll_matrix->blocks[b];
-        int rows_in_block = block.rows_in_block;
-        int max_nz = block.max_nz_per_row;
+        // I blocchi sono consecutivi nei buffer contigui JA/AS
+        const int *JA = hll_matrix->JA + hll_matrix->hack_offset[b];
+        const double *AS = hll_matrix->AS + hll_matrix->hack_offset[b];
+        int rows_in_block = hll_matrix->blocks[b].rows_in_block;
+        int max_nz = hll_matrix->blocks[b].max_nz_per_row;
+        int global_row_offset = b * HackSize;
 
         for (int i = 0; i < rows_in_block; i++) {
             double sum = 0.0;
             for (int j = 0; j < max_nz; j++) {
                 int idx = j * rows_in_block + i;  // ELLPACK column-major access
-                int col = block.JA[idx];
-                double val = block.AS[idx];
-                sum += val * x[col];
+                sum += AS[idx] * x[JA[idx]];
             }
-            y[global_row_offset + i] = sum;
+            // SELL-C-sigma: la riga memorizzata va riportata all'indice originale
+            int row = global_row_offset + i;
+            y[perm ? perm[row] : row] = sum;
         }
-
-        global_row_offset += rows_in_block;
     }
 }
 
@@ -82,80 +91,407 @@ void csr_parallel_mat_per_vec(CSRMatrix *csr_matrix, double *x, double *y) {
 
 void hll_parallel_mat_per_vec_improved(HLLMatrix *hll_matrix, const double *x, double *y) {
     // Cache per evitare accessi ripetuti alla struttura
-    const int M = hll_matrix->M;
     const int HackSize = hll_matrix->HackSize;
     const int num_blocks = hll_matrix->num_blocks;
-    HLLBlock* blocks = hll_matrix->blocks;
-    
+    const int64_t *hack_offset = hll_matrix->hack_offset;
+    const HLLBlock *blocks = hll_matrix->blocks;
+    const int *perm = hll_matrix->perm;
+
     // Parallelizzazione con guided scheduling ottimizzato per bilanciamento carichi
     // Chunk size ridotto a 8 per miglior distribuzione su CPU multi-core
     #pragma omp parallel for schedule(guided, 8)
     for (int block_idx = 0; block_idx < num_blocks; block_idx++) {
-        
-        // Cache locale del blocco corrente per migliorare locality
-        HLLBlock current_block = blocks[block_idx];
-        
-        // Puntatori locali per ridurre dereferenziazioni e migliorare cache performance
-        const double* AS_local = current_block.AS;
-        const int* JA_local = current_block.JA;
-        const double* x_local = x;
-        
-        // Calcolo range righe per il blocco corrente
-        int row_start = block_idx * HackSize;
-        int row_end = (row_start + current_block.rows_in_block <= M) ? 
-                      row_start + current_block.rows_in_block : M;
-        
-        // Cache del max_nz per evitare accessi ripetuti
-        const int max_nz = current_block.max_nz_per_row;
-        
-        // MIGLIORAMENTO 1: Loop unrolling 4x aggressivo (era 2x)
-        // Processa 4 colonne per volta per massimizzare throughput
-        int col;
-        for (col = 0; col < max_nz - 3; col += 4) {
-            
-            // Itera su tutte le righe del blocco
-            for (int row = row_start; row < row_end; row++) {
-                int local_row = row - row_start;
-                
-                // Calcolo base offset per la riga corrente nel formato ELLPACK
-                int base_offset = local_row * max_nz;
-                
-                // UNROLLING 4x: 4 operazioni fused multiply-add simultanee
-                // Riduce latency pipeline e massimizza utilizzo ALU
-                y[row] += AS_local[base_offset + col] * x_local[JA_local[base_offset + col]] +
-                          AS_local[base_offset + col + 1] * x_local[JA_local[base_offset + col + 1]] +
-                          AS_local[base_offset + col + 2] * x_local[JA_local[base_offset + col + 2]] +
-                          AS_local[base_offset + col + 3] * x_local[JA_local[base_offset + col + 3]];
+
+        // Puntatori al blocco corrente nei buffer contigui: blocchi adiacenti
+        // sono adiacenti in memoria, quindi il prefetcher lavora in streaming
+        const double *AS_local = hll_matrix->AS + hack_offset[block_idx];
+        const int *JA_local = hll_matrix->JA + hack_offset[block_idx];
+        const int rows_in_block = blocks[block_idx].rows_in_block;
+        const int max_nz = blocks[block_idx].max_nz_per_row;
+        const int row_offset = block_idx * HackSize;
+
+        // Accumulatori locali al blocco (HackSize righe), azzerati una volta
+        double sum[rows_in_block];
+        for (int row = 0; row < rows_in_block; row++) sum[row] = 0.0;
+
+        // Layout column-major: per ogni colonna ELLPACK le righe del blocco
+        // sono contigue, quindi il loop interno è unit-stride su JA/AS
+        for (int col = 0; col < max_nz; col++) {
+            const double *AS_col = AS_local + col * rows_in_block;
+            const int *JA_col = JA_local + col * rows_in_block;
+            for (int row = 0; row < rows_in_block; row++) {
+                sum[row] += AS_col[row] * x[JA_col[row]];
             }
         }
-        
-        // MIGLIORAMENTO 2: Gestione remainder con unrolling 2x
-        // Per colonne rimanenti che non sono multiple di 4
-        for (; col < max_nz - 1; col += 2) {
-            for (int row = row_start; row < row_end; row++) {
-                int local_row = row - row_start;
-                int base_offset = local_row * max_nz;
-                
-                // UNROLLING 2x per remainder
-                y[row] += AS_local[base_offset + col] * x_local[JA_local[base_offset + col]] +
-                          AS_local[base_offset + col + 1] * x_local[JA_local[base_offset + col + 1]];
+
+        if (perm) {
+            for (int row = 0; row < rows_in_block; row++) y[perm[row_offset + row]] = sum[row];
+        } else {
+            for (int row = 0; row < rows_in_block; row++) y[row_offset + row] = sum[row];
+        }
+    }
+}
+
+void csr_merge_path_mat_per_vec(CSRMatrix *csr_matrix, CSRPartition *part, const double *x, double *y) {
+    const int *IRP = csr_matrix->IRP;
+    const int *JA = csr_matrix->JA;
+    const double *AS = csr_matrix->AS;
+    const int nthreads = part->nthreads;
+
+    // Una partizione per iterazione: anche se il runtime concede meno thread
+    // del previsto tutte le partizioni vengono elaborate
+    #pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+    for (int t = 0; t < nthreads; t++) {
+        int row = part->row_start[t];
+        int nz = part->nz_start[t];
+        const int row_end = part->row_start[t + 1];
+        const int nz_end = part->nz_start[t + 1];
+
+        // Righe che terminano dentro la partizione
+        for (; row < row_end; row++) {
+            double sum = 0.0;
+            for (; nz < IRP[row + 1]; nz++) {
+                sum += AS[nz] * x[JA[nz]];
             }
+            y[row] = sum;
         }
-        
-        // MIGLIORAMENTO 3: Gestione ultima colonna se max_nz è dispari
-        // Evita branch misprediction nel loop principale
-        if (col < max_nz) {
-            for (int row = row_start; row < row_end; row++) {
-                int local_row = row - row_start;
-                int base_offset = local_row * max_nz;
-                
-                // Singola operazione per ultima colonna
-                y[row] += AS_local[base_offset + col] * x_local[JA_local[base_offset + col]];
+
+        // Riga che prosegue nella partizione successiva: somma parziale in carry-out
+        double sum = 0.0;
+        for (; nz < nz_end; nz++) {
+            sum += AS[nz] * x[JA[nz]];
+        }
+        part->carry_row[t] = row_end;
+        part->carry_val[t] = sum;
+    }
+
+    // Fix-up delle righe a cavallo dei confini tra partizioni
+    for (int t = 0; t < nthreads - 1; t++) {
+        if (part->carry_row[t] < csr_matrix->M) {
+            y[part->carry_row[t]] += part->carry_val[t];
+        }
+    }
+}
+
+// Riga i del formato a precisione mista: valori float, accumulo in double
+static inline double csr_mp_row(const CSRMatrixMP *mat, int i, const double *x) {
+    const float *AS = mat->AS;
+    double sum = 0.0;
+
+    if (mat->index_mode == MP_INDEX_INT32) {
+        for (int j = mat->IRP[i]; j < mat->IRP[i + 1]; j++) {
+            sum += (double)AS[j] * x[mat->JA[j]];
+        }
+        return sum;
+    }
+
+    // Decodifica dei delta: la colonna di partenza è l'indice di riga
+    const int16_t *JD = mat->JD + mat->IDXP[i];
+    int col = i;
+    for (int j = mat->IRP[i]; j < mat->IRP[i + 1]; j++) {
+        int16_t d = *JD++;
+        if (d == DELTA16_ESCAPE) {
+            col = (int)(((uint32_t)(uint16_t)JD[0] << 16) | (uint16_t)JD[1]);
+            JD += 2;
+        } else {
+            col += d;
+        }
+        sum += (double)AS[j] * x[col];
+    }
+    return sum;
+}
+
+void csr_mp_serial_mat_per_vec(CSRMatrixMP *mat, const double *x, double *y) {
+    for (int i = 0; i < mat->M; i++) {
+        y[i] = csr_mp_row(mat, i, x);
+    }
+}
+
+void csr_mp_parallel_mat_per_vec(CSRMatrixMP *mat, const double *x, double *y) {
+    #pragma omp parallel for schedule(guided, 64)
+    for (int i = 0; i < mat->M; i++) {
+        y[i] = csr_mp_row(mat, i, x);
+    }
+}
+
+static inline void hll_mp_block(const HLLMatrixMP *mat, int b, const double *x, double *y) {
+    const int rows = (b + 1) * mat->HackSize <= mat->M ? mat->HackSize : mat->M - b * mat->HackSize;
+    const int max_nz = (int)((mat->hack_offset[b + 1] - mat->hack_offset[b]) / rows);
+    const float *AS = mat->AS + mat->hack_offset[b];
+    const int row_offset = b * mat->HackSize;
+    double sum[rows];
+
+    for (int i = 0; i < rows; i++) sum[i] = 0.0;
+
+    if (mat->wide_offset[b + 1] > mat->wide_offset[b]) {
+        const int *JA = mat->JA + mat->wide_offset[b];
+        for (int j = 0; j < max_nz; j++) {
+            for (int i = 0; i < rows; i++) {
+                sum[i] += (double)AS[j * rows + i] * x[JA[j * rows + i]];
+            }
+        }
+    } else {
+        // Colonna = riga globale + delta a 16 bit
+        const int16_t *JD = mat->JD + (mat->hack_offset[b] - mat->wide_offset[b]);
+        for (int j = 0; j < max_nz; j++) {
+            for (int i = 0; i < rows; i++) {
+                sum[i] += (double)AS[j * rows + i] * x[row_offset + i + JD[j * rows + i]];
+            }
+        }
+    }
+
+    for (int i = 0; i < rows; i++) {
+        y[mat->perm ? mat->perm[row_offset + i] : row_offset + i] = sum[i];
+    }
+}
+
+void hll_mp_serial_mat_per_vec(HLLMatrixMP *mat, const double *x, double *y) {
+    for (int b = 0; b < mat->num_blocks; b++) {
+        hll_mp_block(mat, b, x, y);
+    }
+}
+
+void hll_mp_parallel_mat_per_vec(HLLMatrixMP *mat, const double *x, double *y) {
+    #pragma omp parallel for schedule(guided, 8)
+    for (int b = 0; b < mat->num_blocks; b++) {
+        hll_mp_block(mat, b, x, y);
+    }
+}
+
+// Blocco HLL con indici dallo stream compatto: per i blocchi a passo costante
+// le colonne sono rigenerate come base[j] + i * stride senza leggere JA
+static inline void hll_compact_block(const HLLMatrix *hll, const HLLCompactIndex *index, int b,
+                                     const double *x, double *y) {
+    const double *AS = hll->AS + hll->hack_offset[b];
+    const int rows = hll->blocks[b].rows_in_block;
+    const int max_nz = hll->blocks[b].max_nz_per_row;
+    const int row_offset = b * hll->HackSize;
+    const int *data = index->data + index->desc[b].offset;
+    const int stride = index->desc[b].stride;
+    double sum[rows];
+
+    for (int i = 0; i < rows; i++) sum[i] = 0.0;
+
+    if (stride == HLL_INDEX_FULL) {
+        for (int j = 0; j < max_nz; j++) {
+            for (int i = 0; i < rows; i++) {
+                sum[i] += AS[j * rows + i] * x[data[j * rows + i]];
+            }
+        }
+    } else {
+        for (int j = 0; j < max_nz; j++) {
+            const double *x_col = x + data[j];
+            for (int i = 0; i < rows; i++) {
+                sum[i] += AS[j * rows + i] * x_col[i * stride];
+            }
+        }
+    }
+
+    for (int i = 0; i < rows; i++) {
+        y[hll->perm ? hll->perm[row_offset + i] : row_offset + i] = sum[i];
+    }
+}
+
+void hll_compact_serial_mat_per_vec(HLLMatrix *hll_matrix, HLLCompactIndex *index, const double *x, double *y) {
+    for (int b = 0; b < hll_matrix->num_blocks; b++) {
+        hll_compact_block(hll_matrix, index, b, x, y);
+    }
+}
+
+void hll_compact_parallel_mat_per_vec(HLLMatrix *hll_matrix, HLLCompactIndex *index, const double *x, double *y) {
+    #pragma omp parallel for schedule(guided, 8)
+    for (int b = 0; b < hll_matrix->num_blocks; b++) {
+        hll_compact_block(hll_matrix, index, b, x, y);
+    }
+}
+
+// Simmetrica a triangolo inferiore: ogni a_ij fuori diagonale aggiorna sia y[i] sia y[j]
+void csr_sym_serial_mat_per_vec(const CSRSymMatrix *sym, const double *x, double *y) {
+    const CSRMatrix *A = &sym->lower;
+
+    for (int i = 0; i < A->M; i++) y[i] = 0.0;
+
+    for (int i = 0; i < A->M; i++) {
+        const double xi = x[i];
+        double sum = 0.0;
+        for (int j = A->IRP[i]; j < A->IRP[i + 1]; j++) {
+            const int c = A->JA[j];
+            sum += A->AS[j] * x[c];
+            if (c != i) y[c] += A->AS[j] * xi;
+        }
+        y[i] += sum;
+    }
+}
+
+void csr_sym_parallel_mat_per_vec(CSRSymMatrix *sym, const double *x, double *y) {
+    const CSRMatrix *A = &sym->lower;
+    const int nthreads = sym->nthreads;
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        // Ogni partizione scrive solo le proprie righe di y e il proprio buffer:
+        // nessun conflitto anche se un thread esegue più partizioni
+        for (int t = omp_get_thread_num(); t < nthreads; t += omp_get_num_threads()) {
+            const int rs = sym->row_start[t], re = sym->row_start[t + 1];
+            const int lo = sym->partial_lo[t];
+            double *partial = sym->partial + sym->partial_offset[t];
+
+            for (int i = 0; i < rs - lo; i++) partial[i] = 0.0;
+            for (int i = rs; i < re; i++) y[i] = 0.0;
+
+            for (int i = rs; i < re; i++) {
+                const double xi = x[i];
+                double sum = 0.0;
+                for (int j = A->IRP[i]; j < A->IRP[i + 1]; j++) {
+                    const int c = A->JA[j];
+                    sum += A->AS[j] * x[c];
+                    if (c == i) continue;
+                    if (c >= rs) y[c] += A->AS[j] * xi;
+                    else partial[c - lo] += A->AS[j] * xi;
+                }
+                y[i] += sum;
             }
         }
+
+        #pragma omp barrier
+
+        // Riduzione per segmenti disgiunti: ognuno somma solo i buffer che lo coprono
+        #pragma omp for schedule(dynamic, 1)
+        for (int k = 0; k < sym->num_segments; k++) {
+            const int b0 = sym->segment_bounds[k], b1 = sym->segment_bounds[k + 1];
+            for (int s = sym->segment_ptr[k]; s < sym->segment_ptr[k + 1]; s++) {
+                const int t = sym->segment_threads[s];
+                const double *partial = sym->partial + sym->partial_offset[t] - sym->partial_lo[t];
+                for (int i = b0; i < b1; i++) y[i] += partial[i];
+            }
+        }
+    }
+}
+
+// DIA sulle righe [rb, re): diagonale per diagonale, accesso sequenziale a data, x e y
+static inline void dia_rows(const DIAMatrix *A, int rb, int re, const double *x, double *y) {
+    for (int i = rb; i < re; i++) y[i] = 0.0;
+
+    for (int d = 0; d < A->num_diags; d++) {
+        const int off = A->offsets[d];
+        const double *diag = A->data + (size_t)d * A->M;
+        // Righe in cui la diagonale cade dentro la matrice: 0 <= i + off < N
+        int lo = off < 0 ? -off : 0;
+        int hi = A->N - off < A->M ? A->N - off : A->M;
+        if (lo < rb) lo = rb;
+        if (hi > re) hi = re;
+        for (int i = lo; i < hi; i++) y[i] += diag[i] * x[i + off];
     }
-    
-    // NOTA: Eliminato malloc nel path critico rispetto alla versione precedente
-    // La struttura HLLMatrix già contiene tutti i dati pre-allocati
-    // Questo elimina ~10-50μs di overhead per chiamata
-}
\ No newline at end of file
+}
+
+void dia_serial_mat_per_vec(DIAMatrix *dia_matrix, const double *x, double *y) {
+    dia_rows(dia_matrix, 0, dia_matrix->M, x, y);
+}
+
+void dia_parallel_mat_per_vec(DIAMatrix *dia_matrix, const double *x, double *y) {
+    #pragma omp parallel
+    {
+        const int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        const int M = dia_matrix->M;
+        dia_rows(dia_matrix, (int)((long long)M * t / nt), (int)((long long)M * (t + 1) / nt), x, y);
+    }
+}
+
+#define HYB_ROW_TILE 64
+
+// Parte ELL sulle righe [rb, re): tile di righe, k esterno così le letture sono contigue
+static inline void hyb_ell_rows(const HYBMatrix *A, int rb, int re, const double *x, double *y) {
+    double sum[HYB_ROW_TILE];
+
+    for (int tile = rb; tile < re; tile += HYB_ROW_TILE) {
+        const int n = re - tile < HYB_ROW_TILE ? re - tile : HYB_ROW_TILE;
+        for (int i = 0; i < n; i++) sum[i] = 0.0;
+        for (int k = 0; k < A->ell_width; k++) {
+            const int *JA = A->ell_JA + (size_t)k * A->M + tile;
+            const double *AS = A->ell_AS + (size_t)k * A->M + tile;
+            for (int i = 0; i < n; i++) sum[i] += AS[i] * x[JA[i]];
+        }
+        for (int i = 0; i < n; i++) y[tile + i] = sum[i];
+    }
+}
+
+void hyb_serial_mat_per_vec(HYBMatrix *hyb_matrix, const double *x, double *y) {
+    hyb_ell_rows(hyb_matrix, 0, hyb_matrix->M, x, y);
+    for (int k = 0; k < hyb_matrix->coo_nz; k++) {
+        y[hyb_matrix->coo_row[k]] += hyb_matrix->coo_val[k] * x[hyb_matrix->coo_col[k]];
+    }
+}
+
+void hyb_parallel_mat_per_vec(HYBMatrix *hyb_matrix, const double *x, double *y) {
+    const int M = hyb_matrix->M;
+    const int coo_nz = hyb_matrix->coo_nz;
+
+    #pragma omp parallel
+    {
+        const int t = omp_get_thread_num(), nt = omp_get_num_threads();
+
+        #pragma omp for schedule(static)
+        for (int tile = 0; tile < M; tile += HYB_ROW_TILE) {
+            hyb_ell_rows(hyb_matrix, tile, tile + HYB_ROW_TILE < M ? tile + HYB_ROW_TILE : M, x, y);
+        }
+
+        // Coda COO: porzioni uguali di elementi; solo la prima e l'ultima riga
+        // di ogni porzione possono essere condivise con i thread vicini
+        const int kb = (int)((long long)coo_nz * t / nt);
+        const int ke = (int)((long long)coo_nz * (t + 1) / nt);
+        int k = kb;
+        while (k < ke) {
+            const int row = hyb_matrix->coo_row[k];
+            double sum = 0.0;
+            for (; k < ke && hyb_matrix->coo_row[k] == row; k++) {
+                sum += hyb_matrix->coo_val[k] * x[hyb_matrix->coo_col[k]];
+            }
+            const int shared = (kb > 0 && row == hyb_matrix->coo_row[kb - 1] && row == hyb_matrix->coo_row[kb]) ||
+                               (ke < coo_nz && row == hyb_matrix->coo_row[ke]);
+            if (shared) {
+                #pragma omp atomic
+                y[row] += sum;
+            } else {
+                y[row] += sum;
+            }
+        }
+    }
+}
+
+// Righe non vuote del thread t nel pannello p della CSR a pannelli, accumulate in y
+static inline void tiled_panel_rows(const CSRTiledMatrix *A, int p, int t, const double *x, double *y) {
+    const size_t block = (size_t)p * A->nthreads + t;
+    for (int k = A->panel_ptr[block]; k < A->panel_ptr[block + 1]; k++) {
+        double sum = 0.0;
+        for (int j = A->row_ptr[k]; j < A->row_ptr[k + 1]; j++) sum += A->AS[j] * x[A->JA[j]];
+        y[A->row_idx[k]] += sum;
+    }
+}
+
+void csr_tiled_serial_mat_per_vec(CSRTiledMatrix *tiled_matrix, const double *x, double *y) {
+    for (int i = 0; i < tiled_matrix->M; i++) y[i] = 0.0;
+    for (int p = 0; p < tiled_matrix->num_panels; p++) {
+        for (int t = 0; t < tiled_matrix->nthreads; t++) tiled_panel_rows(tiled_matrix, p, t, x, y);
+    }
+}
+
+void csr_tiled_parallel_mat_per_vec(CSRTiledMatrix *tiled_matrix, const double *x, double *y) {
+    const int nthreads = tiled_matrix->nthreads;
+    const int *row_start = tiled_matrix->row_start;
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        const int tid = omp_get_thread_num(), nt = omp_get_num_threads();
+
+        for (int t = tid; t < nthreads; t += nt) {
+            for (int i = row_start[t]; i < row_start[t + 1]; i++) y[i] = 0.0;
+        }
+        // Barriera per pannello: i thread condividono la stessa striscia di x in LLC
+        for (int p = 0; p < tiled_matrix->num_panels; p++) {
+            for (int t = tid; t < nthreads; t += nt) {
+                tiled_panel_rows(tiled_matrix, p, t, x, y);
+            }
+            #pragma omp barrier
+        }
+    }
+}
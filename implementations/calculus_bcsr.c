@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "include/BCSR_Matrix.h"
+#include "include/calculus.h"
+
+/**
+ * SpMV in formato BCSR.
+ *
+ * Per le dimensioni di blocco più comuni (2x2, 3x3, 4x4, 6x6) i kernel sono
+ * generati con R e C costanti: i cicli interni sul blocco sono srotolati e
+ * le R somme restano nei registri per tutta la riga di blocco. Le colonne
+ * di blocco oltre N / C e l'ultima riga di blocco (se M non è multiplo di
+ * R) passano per un percorso con controllo dei limiti.
+ */
+
+typedef void (*BCSRKernel)(const BCSRMatrix *A, int br_begin, int br_end, const double *x, double *y);
+
+// Blocco a cavallo del bordo destro: solo le colonne < N
+static inline void bcsr_edge_block(const double *block, int R, int C, int col0, int N,
+                                   const double *x, double *acc) {
+    for (int r = 0; r < R; r++) {
+        for (int c = 0; c < C && col0 + c < N; c++) acc[r] += block[r * C + c] * x[col0 + c];
+    }
+}
+
+static inline void bcsr_store_rows(const double *acc, int R, int row0, int M, double *y) {
+    for (int r = 0; r < R && row0 + r < M; r++) y[row0 + r] = acc[r];
+}
+
+#define DEFINE_BCSR(R, C)                                                                   \
+static void bcsr_rows_##R##x##C(const BCSRMatrix *A, int br_begin, int br_end,             \
+                                const double *x, double *y) {                              \
+    const int full_nb = A->N / (C);                                                         \
+    for (int br = br_begin; br < br_end; br++) {                                            \
+        double acc[R] = { 0.0 };                                                            \
+        for (int k = A->IRP[br]; k < A->IRP[br + 1]; k++) {                                 \
+            const double *block = A->AS + (size_t)k * ((R) * (C));                          \
+            const int bc = A->JA[k];                                                        \
+            if (bc < full_nb) {                                                             \
+                const double *xb = x + (size_t)bc * (C);                                    \
+                for (int r = 0; r < (R); r++)                                               \
+                    for (int c = 0; c < (C); c++) acc[r] += block[r * (C) + c] * xb[c];     \
+            } else {                                                                        \
+                bcsr_edge_block(block, R, C, bc * (C), A->N, x, acc);                       \
+            }                                                                               \
+        }                                                                                   \
+        bcsr_store_rows(acc, R, br * (R), A->M, y);                                         \
+    }                                                                                       \
+}
+
+DEFINE_BCSR(2, 2)
+DEFINE_BCSR(3, 3)
+DEFINE_BCSR(4, 4)
+DEFINE_BCSR(6, 6)
+
+// Qualsiasi R x C: accumulatori in un buffer di dimensione R
+static void bcsr_rows_generic(const BCSRMatrix *A, int br_begin, int br_end, const double *x, double *y) {
+    const int R = A->R, C = A->C;
+    double acc[R];
+
+    for (int br = br_begin; br < br_end; br++) {
+        for (int r = 0; r < R; r++) acc[r] = 0.0;
+        for (int k = A->IRP[br]; k < A->IRP[br + 1]; k++) {
+            bcsr_edge_block(A->AS + (size_t)k * R * C, R, C, A->JA[k] * C, A->N, x, acc);
+        }
+        bcsr_store_rows(acc, R, br * R, A->M, y);
+    }
+}
+
+static BCSRKernel select_bcsr_kernel(const BCSRMatrix *A) {
+    if (A->R == 2 && A->C == 2) return bcsr_rows_2x2;
+    if (A->R == 3 && A->C == 3) return bcsr_rows_3x3;
+    if (A->R == 4 && A->C == 4) return bcsr_rows_4x4;
+    if (A->R == 6 && A->C == 6) return bcsr_rows_6x6;
+    return bcsr_rows_generic;
+}
+
+void bcsr_serial_mat_per_vec(BCSRMatrix *bcsr_matrix, const double *x, double *y) {
+    select_bcsr_kernel(bcsr_matrix)(bcsr_matrix, 0, bcsr_matrix->MB, x, y);
+}
+
+void bcsr_parallel_mat_per_vec(BCSRMatrix *bcsr_matrix, const double *x, double *y) {
+    BCSRKernel kernel = select_bcsr_kernel(bcsr_matrix);
+    const int MB = bcsr_matrix->MB;
+
+    #pragma omp parallel for schedule(guided, 1)
+    for (int br = 0; br < MB; br += 16) {
+        kernel(bcsr_matrix, br, br + 16 < MB ? br + 16 : MB, x, y);
+    }
+}
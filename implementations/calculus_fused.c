@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/calculus.h"
+
+/**
+ * SpMV fusa con le operazioni vettoriali dei solutori iterativi:
+ * y = alpha * A * x + beta * y, più un prodotto scalare opzionale
+ * calcolato sulla stessa passata (riduzione OpenMP).
+ *
+ * Con beta == 0 y non viene letto (può contenere qualsiasi valore), come
+ * nella BLAS. SPMV_DOT_XAX restituisce <x, A x> e richiede M == N;
+ * SPMV_DOT_YY restituisce <y, y> sul y appena scritto.
+ */
+
+// Scrive la riga row di y e restituisce il suo contributo al prodotto scalare
+static inline double fused_store(double ax, int row, double alpha, double beta,
+                                 const double *x, double *y, SpmvDot dot) {
+    const double v = beta != 0.0 ? alpha * ax + beta * y[row] : alpha * ax;
+    y[row] = v;
+    if (dot == SPMV_DOT_XAX) return x[row] * ax;
+    if (dot == SPMV_DOT_YY) return v * v;
+    return 0.0;
+}
+
+static inline double csr_row_dot(const CSRMatrix *csr, int i, const double *x) {
+    const int *JA = csr->JA;
+    const double *AS = csr->AS;
+    const int row_end = csr->IRP[i + 1];
+    double sum = 0.0;
+    int j = csr->IRP[i];
+    for (; j <= row_end - 4; j += 4) {
+        sum += AS[j]     * x[JA[j]];
+        sum += AS[j + 1] * x[JA[j + 1]];
+        sum += AS[j + 2] * x[JA[j + 2]];
+        sum += AS[j + 3] * x[JA[j + 3]];
+    }
+    for (; j < row_end; j++) sum += AS[j] * x[JA[j]];
+    return sum;
+}
+
+static int fused_check(int M, int N, SpmvDot dot) {
+    if (dot == SPMV_DOT_XAX && M != N) {
+        printf("<x, Ax> richiede una matrice quadrata (%d x %d)\n", M, N);
+        return 0;
+    }
+    return 1;
+}
+
+double csr_fused_serial_mat_per_vec(CSRMatrix *csr_matrix, double alpha, const double *x,
+                                    double beta, double *y, SpmvDot dot) {
+    if (!fused_check(csr_matrix->M, csr_matrix->N, dot)) dot = SPMV_DOT_NONE;
+    double result = 0.0;
+    for (int i = 0; i < csr_matrix->M; i++) {
+        result += fused_store(csr_row_dot(csr_matrix, i, x), i, alpha, beta, x, y, dot);
+    }
+    return result;
+}
+
+double csr_fused_parallel_mat_per_vec(CSRMatrix *csr_matrix, double alpha, const double *x,
+                                      double beta, double *y, SpmvDot dot) {
+    if (!fused_check(csr_matrix->M, csr_matrix->N, dot)) dot = SPMV_DOT_NONE;
+    double result = 0.0;
+    #pragma omp parallel for schedule(guided, 64) reduction(+:result)
+    for (int i = 0; i < csr_matrix->M; i++) {
+        result += fused_store(csr_row_dot(csr_matrix, i, x), i, alpha, beta, x, y, dot);
+    }
+    return result;
+}
+
+// Blocco b della HLL: somme locali column-major, poi scrittura fusa riga per riga
+static inline double hll_fused_block(const HLLMatrix *hll, int b, double alpha, const double *x,
+                                     double beta, double *y, SpmvDot dot) {
+    const double *AS = hll->AS + hll->hack_offset[b];
+    const int *JA = hll->JA + hll->hack_offset[b];
+    const int rows_in_block = hll->blocks[b].rows_in_block;
+    const int max_nz = hll->blocks[b].max_nz_per_row;
+    const int row_offset = b * hll->HackSize;
+    const int *perm = hll->perm;
+
+    double sum[rows_in_block];
+    for (int row = 0; row < rows_in_block; row++) sum[row] = 0.0;
+    for (int col = 0; col < max_nz; col++) {
+        const double *AS_col = AS + col * rows_in_block;
+        const int *JA_col = JA + col * rows_in_block;
+        for (int row = 0; row < rows_in_block; row++) sum[row] += AS_col[row] * x[JA_col[row]];
+    }
+
+    double result = 0.0;
+    for (int row = 0; row < rows_in_block; row++) {
+        const int i = perm ? perm[row_offset + row] : row_offset + row;
+        result += fused_store(sum[row], i, alpha, beta, x, y, dot);
+    }
+    return result;
+}
+
+double hll_fused_serial_mat_per_vec(HLLMatrix *hll_matrix, double alpha, const double *x,
+                                    double beta, double *y, SpmvDot dot) {
+    if (!fused_check(hll_matrix->M, hll_matrix->N, dot)) dot = SPMV_DOT_NONE;
+    double result = 0.0;
+    for (int b = 0; b < hll_matrix->num_blocks; b++) {
+        result += hll_fused_block(hll_matrix, b, alpha, x, beta, y, dot);
+    }
+    return result;
+}
+
+double hll_fused_parallel_mat_per_vec(HLLMatrix *hll_matrix, double alpha, const double *x,
+                                      double beta, double *y, SpmvDot dot) {
+    if (!fused_check(hll_matrix->M, hll_matrix->N, dot)) dot = SPMV_DOT_NONE;
+    double result = 0.0;
+    #pragma omp parallel for schedule(guided, 8) reduction(+:result)
+    for (int b = 0; b < hll_matrix->num_blocks; b++) {
+        result += hll_fused_block(hll_matrix, b, alpha, x, beta, y, dot);
+    }
+    return result;
+}
@@ -0,0 +1,367 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/calculus.h"
+
+/**
+ * Kernel SIMD per il formato HLL.
+ *
+ * Nel layout column-major di un blocco l'elemento j-esimo delle righe
+ * consecutive i, i+1, ... è contiguo in memoria (idx = j * rows_in_block + i),
+ * quindi un vettore di AS e di JA copre più righe dello stesso hack:
+ * x[JA] si carica con un gather e il contributo si accumula con una FMA
+ * per riga. Le righe residue (meno di una larghezza di vettore) usano load
+ * e gather mascherati con AVX-512, codice scalare con AVX2.
+ */
+
+// I kernel di blocco scrivono le rows_in_block righe memorizzate del blocco b in y_block
+typedef void (*HLLBlockKernel)(const HLLMatrix *hll, int b, const double *x, double *y_block);
+
+static void hll_block_scalar(const HLLMatrix *hll, int b, const double *x, double *y_block) {
+    const int *JA = hll->JA + hll->hack_offset[b];
+    const double *AS = hll->AS + hll->hack_offset[b];
+    const int rows = hll->blocks[b].rows_in_block;
+    const int max_nz = hll->blocks[b].max_nz_per_row;
+
+    for (int i = 0; i < rows; i++) {
+        double sum = 0.0;
+        for (int j = 0; j < max_nz; j++) {
+            sum += AS[j * rows + i] * x[JA[j * rows + i]];
+        }
+        y_block[i] = sum;
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void hll_block_avx2(const HLLMatrix *hll, int b, const double *x, double *y_block) {
+    const int *JA = hll->JA + hll->hack_offset[b];
+    const double *AS = hll->AS + hll->hack_offset[b];
+    const int rows = hll->blocks[b].rows_in_block;
+    const int max_nz = hll->blocks[b].max_nz_per_row;
+    int i = 0;
+
+    // 16 righe per volta: 4 accumulatori indipendenti da 4 double
+    for (; i + 16 <= rows; i += 16) {
+        __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+        __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+        for (int j = 0; j < max_nz; j++) {
+            const int base = j * rows + i;
+            __m128i idx0 = _mm_loadu_si128((const __m128i *)(JA + base));
+            __m128i idx1 = _mm_loadu_si128((const __m128i *)(JA + base + 4));
+            __m128i idx2 = _mm_loadu_si128((const __m128i *)(JA + base + 8));
+            __m128i idx3 = _mm_loadu_si128((const __m128i *)(JA + base + 12));
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(AS + base), _mm256_i32gather_pd(x, idx0, 8), acc0);
+            acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(AS + base + 4), _mm256_i32gather_pd(x, idx1, 8), acc1);
+            acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(AS + base + 8), _mm256_i32gather_pd(x, idx2, 8), acc2);
+            acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(AS + base + 12), _mm256_i32gather_pd(x, idx3, 8), acc3);
+        }
+        _mm256_storeu_pd(y_block + i, acc0);
+        _mm256_storeu_pd(y_block + i + 4, acc1);
+        _mm256_storeu_pd(y_block + i + 8, acc2);
+        _mm256_storeu_pd(y_block + i + 12, acc3);
+    }
+
+    for (; i + 4 <= rows; i += 4) {
+        __m256d acc = _mm256_setzero_pd();
+        for (int j = 0; j < max_nz; j++) {
+            const int base = j * rows + i;
+            __m128i idx = _mm_loadu_si128((const __m128i *)(JA + base));
+            acc = _mm256_fmadd_pd(_mm256_loadu_pd(AS + base), _mm256_i32gather_pd(x, idx, 8), acc);
+        }
+        _mm256_storeu_pd(y_block + i, acc);
+    }
+
+    for (; i < rows; i++) {
+        double sum = 0.0;
+        for (int j = 0; j < max_nz; j++) {
+            sum += AS[j * rows + i] * x[JA[j * rows + i]];
+        }
+        y_block[i] = sum;
+    }
+}
+
+__attribute__((target("avx512f")))
+static void hll_block_avx512(const HLLMatrix *hll, int b, const double *x, double *y_block) {
+    const int *JA = hll->JA + hll->hack_offset[b];
+    const double *AS = hll->AS + hll->hack_offset[b];
+    const int rows = hll->blocks[b].rows_in_block;
+    const int max_nz = hll->blocks[b].max_nz_per_row;
+    int i = 0;
+
+    // 32 righe per volta: 4 accumulatori indipendenti da 8 double
+    for (; i + 32 <= rows; i += 32) {
+        __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+        __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+        for (int j = 0; j < max_nz; j++) {
+            const int base = j * rows + i;
+            __m512i idx01 = _mm512_loadu_si512((const void *)(JA + base));
+            __m512i idx23 = _mm512_loadu_si512((const void *)(JA + base + 16));
+            __m512d x0 = _mm512_i32gather_pd(_mm512_castsi512_si256(idx01), x, 8);
+            __m512d x1 = _mm512_i32gather_pd(_mm512_extracti64x4_epi64(idx01, 1), x, 8);
+            __m512d x2 = _mm512_i32gather_pd(_mm512_castsi512_si256(idx23), x, 8);
+            __m512d x3 = _mm512_i32gather_pd(_mm512_extracti64x4_epi64(idx23, 1), x, 8);
+            acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(AS + base), x0, acc0);
+            acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(AS + base + 8), x1, acc1);
+            acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(AS + base + 16), x2, acc2);
+            acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(AS + base + 24), x3, acc3);
+        }
+        _mm512_storeu_pd(y_block + i, acc0);
+        _mm512_storeu_pd(y_block + i + 8, acc1);
+        _mm512_storeu_pd(y_block + i + 16, acc2);
+        _mm512_storeu_pd(y_block + i + 24, acc3);
+    }
+
+    // 8 righe per volta, con maschera per le ultime (< 8) righe del blocco
+    for (; i < rows; i += 8) {
+        const int left = rows - i;
+        const __mmask8 mask = left >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << left) - 1);
+        const __mmask16 mask_idx = (__mmask16)mask;
+        __m512d acc = _mm512_setzero_pd();
+        for (int j = 0; j < max_nz; j++) {
+            const int base = j * rows + i;
+            __m256i idx = _mm512_castsi512_si256(_mm512_maskz_loadu_epi32(mask_idx, JA + base));
+            __m512d xv = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, idx, x, 8);
+            acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, AS + base), xv, acc);
+        }
+        _mm512_mask_storeu_pd(y_block + i, mask, acc);
+    }
+}
+
+/**
+ * Kernel SIMD per il formato CSR.
+ *
+ * Le righe lunghe usano 4 accumulatori vettoriali indipendenti, così le FMA
+ * successive non dipendono l'una dall'altra, gather su x[JA[j]] e una coda
+ * mascherata per gli elementi che non riempiono un vettore. Le righe con
+ * meno di CSR_SHORT_ROW elementi seguono un percorso scalare dedicato, dove
+ * il costo di setup e riduzione orizzontale non verrebbe ammortizzato.
+ */
+
+#define CSR_SHORT_ROW 8
+
+static inline double csr_row_scalar(const int *JA, const double *AS, int start, int end,
+                                    const double *x) {
+    double sum0 = 0.0, sum1 = 0.0;
+    int j = start;
+    for (; j + 2 <= end; j += 2) {
+        sum0 += AS[j] * x[JA[j]];
+        sum1 += AS[j + 1] * x[JA[j + 1]];
+    }
+    if (j < end) sum0 += AS[j] * x[JA[j]];
+    return sum0 + sum1;
+}
+
+static void csr_rows_scalar(const CSRMatrix *csr, int row_begin, int row_end,
+                            const double *x, double *y) {
+    for (int i = row_begin; i < row_end; i++) {
+        y[i] = csr_row_scalar(csr->JA, csr->AS, csr->IRP[i], csr->IRP[i + 1], x);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void csr_rows_avx2(const CSRMatrix *csr, int row_begin, int row_end,
+                          const double *x, double *y) {
+    const int *JA = csr->JA;
+    const double *AS = csr->AS;
+
+    for (int i = row_begin; i < row_end; i++) {
+        const int start = csr->IRP[i];
+        const int end = csr->IRP[i + 1];
+        if (end - start < CSR_SHORT_ROW) {
+            y[i] = csr_row_scalar(JA, AS, start, end, x);
+            continue;
+        }
+
+        __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+        __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+        int j = start;
+        for (; j + 16 <= end; j += 16) {
+            __m128i idx0 = _mm_loadu_si128((const __m128i *)(JA + j));
+            __m128i idx1 = _mm_loadu_si128((const __m128i *)(JA + j + 4));
+            __m128i idx2 = _mm_loadu_si128((const __m128i *)(JA + j + 8));
+            __m128i idx3 = _mm_loadu_si128((const __m128i *)(JA + j + 12));
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(AS + j), _mm256_i32gather_pd(x, idx0, 8), acc0);
+            acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(AS + j + 4), _mm256_i32gather_pd(x, idx1, 8), acc1);
+            acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(AS + j + 8), _mm256_i32gather_pd(x, idx2, 8), acc2);
+            acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(AS + j + 12), _mm256_i32gather_pd(x, idx3, 8), acc3);
+        }
+        for (; j + 4 <= end; j += 4) {
+            __m128i idx = _mm_loadu_si128((const __m128i *)(JA + j));
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(AS + j), _mm256_i32gather_pd(x, idx, 8), acc0);
+        }
+        if (j < end) {
+            // Coda mascherata: le lane spente non leggono né JA/AS né x
+            const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+            const __m128i mask32 = _mm_cmpgt_epi32(_mm_set1_epi32(end - j), lanes);
+            const __m256d mask64 = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(mask32));
+            __m128i idx = _mm_maskload_epi32(JA + j, mask32);
+            __m256d xv = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, idx, mask64, 8);
+            acc1 = _mm256_fmadd_pd(_mm256_maskload_pd(AS + j, _mm256_castpd_si256(mask64)), xv, acc1);
+        }
+
+        __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+        __m128d lo = _mm256_castpd256_pd128(acc);
+        __m128d hi = _mm256_extractf128_pd(acc, 1);
+        lo = _mm_add_pd(lo, hi);
+        y[i] = _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void csr_rows_avx512(const CSRMatrix *csr, int row_begin, int row_end,
+                            const double *x, double *y) {
+    const int *JA = csr->JA;
+    const double *AS = csr->AS;
+
+    for (int i = row_begin; i < row_end; i++) {
+        const int start = csr->IRP[i];
+        const int end = csr->IRP[i + 1];
+        if (end - start < CSR_SHORT_ROW) {
+            y[i] = csr_row_scalar(JA, AS, start, end, x);
+            continue;
+        }
+
+        __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+        __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+        int j = start;
+        for (; j + 32 <= end; j += 32) {
+            __m512i idx01 = _mm512_loadu_si512((const void *)(JA + j));
+            __m512i idx23 = _mm512_loadu_si512((const void *)(JA + j + 16));
+            __m512d x0 = _mm512_i32gather_pd(_mm512_castsi512_si256(idx01), x, 8);
+            __m512d x1 = _mm512_i32gather_pd(_mm512_extracti64x4_epi64(idx01, 1), x, 8);
+            __m512d x2 = _mm512_i32gather_pd(_mm512_castsi512_si256(idx23), x, 8);
+            __m512d x3 = _mm512_i32gather_pd(_mm512_extracti64x4_epi64(idx23, 1), x, 8);
+            acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(AS + j), x0, acc0);
+            acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(AS + j + 8), x1, acc1);
+            acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(AS + j + 16), x2, acc2);
+            acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(AS + j + 24), x3, acc3);
+        }
+        for (; j + 8 <= end; j += 8) {
+            __m256i idx = _mm512_castsi512_si256(_mm512_maskz_loadu_epi32((__mmask16)0xFF, JA + j));
+            acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(AS + j), _mm512_i32gather_pd(idx, x, 8), acc0);
+        }
+        if (j < end) {
+            const __mmask8 mask = (__mmask8)((1u << (end - j)) - 1);
+            __m256i idx = _mm512_castsi512_si256(_mm512_maskz_loadu_epi32((__mmask16)mask, JA + j));
+            __m512d xv = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, idx, x, 8);
+            acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, AS + j), xv, acc1);
+        }
+
+        y[i] = _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+    }
+}
+
+static const char *simd_level_names[] = { "scalar", "avx2", "avx512" };
+
+const char* simd_level_name(SimdLevel level) {
+    return simd_level_names[level];
+}
+
+SimdLevel detect_simd_level(void) {
+    static int cached = -1;
+    if (cached >= 0) return (SimdLevel)cached;
+
+    SimdLevel level = SIMD_SCALAR;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        level = SIMD_AVX512;
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        level = SIMD_AVX2;
+    }
+
+    // Override per confronti: si può solo scendere rispetto a quanto supportato
+    const char *env = getenv("SPMV_SIMD");
+    if (env) {
+        for (int l = SIMD_SCALAR; l <= SIMD_AVX512; l++) {
+            if (strcmp(env, simd_level_names[l]) == 0 && l < (int)level) level = (SimdLevel)l;
+        }
+    }
+
+    cached = level;
+    return level;
+}
+
+// Esegue il blocco b; con SELL-C-sigma il risultato passa da un buffer
+// locale e viene scritto in y secondo la permutazione delle righe
+static inline void run_hll_block(HLLBlockKernel kernel, const HLLMatrix *hll, int b,
+                                 const double *x, double *y) {
+    const int row_offset = b * hll->HackSize;
+    if (!hll->perm) {
+        kernel(hll, b, x, y + row_offset);
+        return;
+    }
+
+    const int rows = hll->blocks[b].rows_in_block;
+    double tmp[rows];
+    kernel(hll, b, x, tmp);
+    for (int i = 0; i < rows; i++) y[hll->perm[row_offset + i]] = tmp[i];
+}
+
+#define DEFINE_HLL_BLOCKS(NAME, BLOCK_KERNEL)                                               \
+static void NAME(const HLLMatrix *hll, int first_block, int last_block,                    \
+                 const double *x, double *y) {                                             \
+    for (int b = first_block; b < last_block; b++) run_hll_block(BLOCK_KERNEL, hll, b, x, y); \
+}
+
+DEFINE_HLL_BLOCKS(hll_blocks_scalar, hll_block_scalar)
+DEFINE_HLL_BLOCKS(hll_blocks_avx2, hll_block_avx2)
+DEFINE_HLL_BLOCKS(hll_blocks_avx512, hll_block_avx512)
+
+HLLBlocksKernel hll_simd_blocks_kernel(SimdLevel level) {
+    switch (level) {
+        case SIMD_AVX512: return hll_blocks_avx512;
+        case SIMD_AVX2:   return hll_blocks_avx2;
+        default:          return hll_blocks_scalar;
+    }
+}
+
+CSRRowsKernel csr_simd_rows_kernel(SimdLevel level) {
+    switch (level) {
+        case SIMD_AVX512: return csr_rows_avx512;
+        case SIMD_AVX2:   return csr_rows_avx2;
+        default:          return csr_rows_scalar;
+    }
+}
+
+void hll_simd_mat_per_vec_blocks(const HLLMatrix *hll_matrix, int first_block, int last_block,
+                                 const double *x, double *y) {
+    hll_simd_blocks_kernel(detect_simd_level())(hll_matrix, first_block, last_block, x, y);
+}
+
+void hll_serial_simd_mat_per_vec(HLLMatrix *hll_matrix, const double *x, double *y) {
+    hll_simd_mat_per_vec_blocks(hll_matrix, 0, hll_matrix->num_blocks, x, y);
+}
+
+void hll_parallel_simd_mat_per_vec(HLLMatrix *hll_matrix, const double *x, double *y) {
+    HLLBlocksKernel kernel = hll_simd_blocks_kernel(detect_simd_level());
+    const int num_blocks = hll_matrix->num_blocks;
+
+    #pragma omp parallel for schedule(guided, 8)
+    for (int b = 0; b < num_blocks; b++) {
+        kernel(hll_matrix, b, b + 1, x, y);
+    }
+}
+
+void csr_simd_mat_per_vec_rows(const CSRMatrix *csr_matrix, int row_begin, int row_end,
+                               const double *x, double *y) {
+    csr_simd_rows_kernel(detect_simd_level())(csr_matrix, row_begin, row_end, x, y);
+}
+
+void csr_serial_simd_mat_per_vec(CSRMatrix *csr_matrix, const double *x, double *y) {
+    csr_simd_mat_per_vec_rows(csr_matrix, 0, csr_matrix->M, x, y);
+}
+
+void csr_parallel_simd_mat_per_vec(CSRMatrix *csr_matrix, const double *x, double *y) {
+    CSRRowsKernel kernel = csr_simd_rows_kernel(detect_simd_level());
+    const int M = csr_matrix->M;
+
+    // Stesso scheduling di csr_parallel_mat_per_vec, a blocchi di 64 righe
+    #pragma omp parallel for schedule(guided, 1)
+    for (int i = 0; i < M; i += 64) {
+        kernel(csr_matrix, i, i + 64 < M ? i + 64 : M, x, y);
+    }
+}
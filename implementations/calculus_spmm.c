@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/calculus.h"
+
+/**
+ * Prodotto matrice sparsa per blocco di vettori (SpMM): Y = A * X.
+ *
+ * X (N x k) e Y (M x k) sono densi row-major, quindi i k valori
+ * X[JA[j], 0..k-1] sono contigui: ogni elemento AS[j]/JA[j] viene letto
+ * una sola volta e applicato a tutte le k colonne, ammortizzando il
+ * traffico della matrice sui vettori. Per k = 1..SPMM_MAX_SPECIALIZED
+ * i kernel sono generati con k costante, così gli accumulatori restano
+ * nei registri e il ciclo su k è completamente srotolato.
+ */
+
+#define SPMM_MAX_SPECIALIZED 16
+
+typedef void (*CSRSpmmKernel)(const CSRMatrix *csr, int row_begin, int row_end,
+                              const double *X, int k, double *Y);
+typedef void (*HLLSpmmKernel)(const HLLMatrix *hll, int b, const double *X, int k, double *Y);
+
+#define DEFINE_CSR_SPMM(K)                                                              \
+static void csr_spmm_rows_k##K(const CSRMatrix *csr, int row_begin, int row_end,       \
+                               const double *X, int k, double *Y) {                    \
+    (void)k;                                                                            \
+    for (int i = row_begin; i < row_end; i++) {                                         \
+        double acc[K] = { 0.0 };                                                        \
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; j++) {                           \
+            const double a = csr->AS[j];                                                \
+            const double *x_row = X + (size_t)csr->JA[j] * K;                           \
+            for (int c = 0; c < K; c++) acc[c] += a * x_row[c];                         \
+        }                                                                               \
+        double *y_row = Y + (size_t)i * K;                                              \
+        for (int c = 0; c < K; c++) y_row[c] = acc[c];                                  \
+    }                                                                                   \
+}
+
+#define DEFINE_HLL_SPMM(K)                                                              \
+static void hll_spmm_block_k##K(const HLLMatrix *hll, int b, const double *X, int k,   \
+                                double *Y) {                                            \
+    (void)k;                                                                            \
+    const int *JA = hll->JA + hll->hack_offset[b];                                      \
+    const double *AS = hll->AS + hll->hack_offset[b];                                   \
+    const int rows = hll->blocks[b].rows_in_block;                                      \
+    const int max_nz = hll->blocks[b].max_nz_per_row;                                   \
+    const int row_offset = b * hll->HackSize;                                           \
+    for (int i = 0; i < rows; i++) {                                                    \
+        double acc[K] = { 0.0 };                                                        \
+        for (int j = 0; j < max_nz; j++) {                                              \
+            const int idx = j * rows + i;                                               \
+            const double a = AS[idx];                                                   \
+            const double *x_row = X + (size_t)JA[idx] * K;                              \
+            for (int c = 0; c < K; c++) acc[c] += a * x_row[c];                         \
+        }                                                                               \
+        const int row = hll->perm ? hll->perm[row_offset + i] : row_offset + i;         \
+        double *y_row = Y + (size_t)row * K;                                            \
+        for (int c = 0; c < K; c++) y_row[c] = acc[c];                                  \
+    }                                                                                   \
+}
+
+#define DEFINE_SPMM(K) DEFINE_CSR_SPMM(K) DEFINE_HLL_SPMM(K)
+
+DEFINE_SPMM(1)  DEFINE_SPMM(2)  DEFINE_SPMM(3)  DEFINE_SPMM(4)
+DEFINE_SPMM(5)  DEFINE_SPMM(6)  DEFINE_SPMM(7)  DEFINE_SPMM(8)
+DEFINE_SPMM(9)  DEFINE_SPMM(10) DEFINE_SPMM(11) DEFINE_SPMM(12)
+DEFINE_SPMM(13) DEFINE_SPMM(14) DEFINE_SPMM(15) DEFINE_SPMM(16)
+
+// Kernel generici per k > SPMM_MAX_SPECIALIZED: accumulano direttamente in Y
+static void csr_spmm_rows_generic(const CSRMatrix *csr, int row_begin, int row_end,
+                                  const double *X, int k, double *Y) {
+    for (int i = row_begin; i < row_end; i++) {
+        double *y_row = Y + (size_t)i * k;
+        for (int c = 0; c < k; c++) y_row[c] = 0.0;
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; j++) {
+            const double a = csr->AS[j];
+            const double *x_row = X + (size_t)csr->JA[j] * k;
+            for (int c = 0; c < k; c++) y_row[c] += a * x_row[c];
+        }
+    }
+}
+
+static void hll_spmm_block_generic(const HLLMatrix *hll, int b, const double *X, int k, double *Y) {
+    const int *JA = hll->JA + hll->hack_offset[b];
+    const double *AS = hll->AS + hll->hack_offset[b];
+    const int rows = hll->blocks[b].rows_in_block;
+    const int max_nz = hll->blocks[b].max_nz_per_row;
+    const int row_offset = b * hll->HackSize;
+
+    for (int i = 0; i < rows; i++) {
+        const int row = hll->perm ? hll->perm[row_offset + i] : row_offset + i;
+        double *y_row = Y + (size_t)row * k;
+        for (int c = 0; c < k; c++) y_row[c] = 0.0;
+        for (int j = 0; j < max_nz; j++) {
+            const int idx = j * rows + i;
+            const double a = AS[idx];
+            const double *x_row = X + (size_t)JA[idx] * k;
+            for (int c = 0; c < k; c++) y_row[c] += a * x_row[c];
+        }
+    }
+}
+
+static const CSRSpmmKernel csr_spmm_kernels[SPMM_MAX_SPECIALIZED + 1] = {
+    NULL,
+    csr_spmm_rows_k1,  csr_spmm_rows_k2,  csr_spmm_rows_k3,  csr_spmm_rows_k4,
+    csr_spmm_rows_k5,  csr_spmm_rows_k6,  csr_spmm_rows_k7,  csr_spmm_rows_k8,
+    csr_spmm_rows_k9,  csr_spmm_rows_k10, csr_spmm_rows_k11, csr_spmm_rows_k12,
+    csr_spmm_rows_k13, csr_spmm_rows_k14, csr_spmm_rows_k15, csr_spmm_rows_k16
+};
+
+static const HLLSpmmKernel hll_spmm_kernels[SPMM_MAX_SPECIALIZED + 1] = {
+    NULL,
+    hll_spmm_block_k1,  hll_spmm_block_k2,  hll_spmm_block_k3,  hll_spmm_block_k4,
+    hll_spmm_block_k5,  hll_spmm_block_k6,  hll_spmm_block_k7,  hll_spmm_block_k8,
+    hll_spmm_block_k9,  hll_spmm_block_k10, hll_spmm_block_k11, hll_spmm_block_k12,
+    hll_spmm_block_k13, hll_spmm_block_k14, hll_spmm_block_k15, hll_spmm_block_k16
+};
+
+static inline CSRSpmmKernel select_csr_spmm(int k) {
+    return k <= SPMM_MAX_SPECIALIZED ? csr_spmm_kernels[k] : csr_spmm_rows_generic;
+}
+
+static inline HLLSpmmKernel select_hll_spmm(int k) {
+    return k <= SPMM_MAX_SPECIALIZED ? hll_spmm_kernels[k] : hll_spmm_block_generic;
+}
+
+void csr_serial_mat_per_mat(CSRMatrix *csr_matrix, const double *X, int k, double *Y) {
+    if (k <= 0) return;
+    select_csr_spmm(k)(csr_matrix, 0, csr_matrix->M, X, k, Y);
+}
+
+void csr_parallel_mat_per_mat(CSRMatrix *csr_matrix, const double *X, int k, double *Y) {
+    if (k <= 0) return;
+    CSRSpmmKernel kernel = select_csr_spmm(k);
+    const int M = csr_matrix->M;
+
+    #pragma omp parallel for schedule(guided, 1)
+    for (int i = 0; i < M; i += 64) {
+        kernel(csr_matrix, i, i + 64 < M ? i + 64 : M, X, k, Y);
+    }
+}
+
+void hll_serial_mat_per_mat(HLLMatrix *hll_matrix, const double *X, int k, double *Y) {
+    if (k <= 0) return;
+    HLLSpmmKernel kernel = select_hll_spmm(k);
+    for (int b = 0; b < hll_matrix->num_blocks; b++) {
+        kernel(hll_matrix, b, X, k, Y);
+    }
+}
+
+void hll_parallel_mat_per_mat(HLLMatrix *hll_matrix, const double *X, int k, double *Y) {
+    if (k <= 0) return;
+    HLLSpmmKernel kernel = select_hll_spmm(k);
+    const int num_blocks = hll_matrix->num_blocks;
+
+    #pragma omp parallel for schedule(guided, 8)
+    for (int b = 0; b < num_blocks; b++) {
+        kernel(hll_matrix, b, X, k, Y);
+    }
+}
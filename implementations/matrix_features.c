@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/SYM_Matrix.h"
+#include "include/DIA_Matrix.h"
+#include "include/HYB_Matrix.h"
+#include "include/BCSR_Matrix.h"
+#include "include/TILED_Matrix.h"
+#include "include/reorder.h"
+#include "include/cache_info.h"
+#include "include/spmv_plan.h"
+#include "include/matrix_features.h"
+
+// Soglie di selezione: HLL conviene solo se il padding resta contenuto e le
+// righe sono abbastanza lunghe da riempire i vettori SIMD di una colonna
+#define HLL_MAX_PADDING_RATIO 1.25
+#define HLL_MAX_ROW_CV 0.5
+#define HLL_MIN_ROW_MEAN 4.0
+
+// Finestra SELL-C-sigma valutata, in multipli di HackSize
+#define SELL_SIGMA_FACTOR 8
+
+// DIA: 8 byte per slot contro i 12 per non-zero della CSR, con margine per
+// le diagonali parziali ai bordi
+#define DIA_SELECT_MAX_FILL 1.25
+
+// SYM: ogni thread scrive e rilegge un buffer parziale lungo al più bandwidth
+// righe; conviene finché i buffer restano sotto il traffico risparmiato (NZ / 2)
+#define SYM_MAX_PARTIAL_RATIO 0.5
+
+// HYB: la coda COO costa 16 byte per elemento e gli aggiornamenti di bordo
+// sono atomici, quindi deve restare una piccola frazione dei non-zero
+#define HYB_MAX_COO_FRACTION 0.2
+
+// PCG Jacobi: utile quando la diagonale pesa almeno quanto il resto della riga
+// nella maggior parte delle righe
+#define JACOBI_MIN_DOMINANCE 0.5
+
+void compute_matrix_features(const CSRMatrix* csr, int hack_size, int symmetric, int panel_width,
+                             MatrixFeatures* f) {
+    const int M = csr->M;
+
+    f->M = M;
+    f->N = csr->N;
+    f->NZ = csr->NZ;
+    f->symmetric = symmetric;
+    f->hack_size = hack_size;
+    f->row_mean = M > 0 ? (double)csr->NZ / M : 0.0;
+    f->hyb_ell_width = hyb_select_ell_width(csr);
+
+    const int ell_width = f->hyb_ell_width;
+    double var = 0.0;
+    int row_max = 0, empty = 0, dominant = 0;
+    long long stored = 0, coo = 0;
+
+    #pragma omp parallel for schedule(static) reduction(+:var, empty, dominant, stored, coo) reduction(max:row_max)
+    for (int i = 0; i < M; ++i) {
+        int len = csr->IRP[i + 1] - csr->IRP[i];
+        double d = len - f->row_mean;
+        var += d * d;
+        if (len > row_max) row_max = len;
+        if (len == 0) empty++;
+        if (len > ell_width) coo += len - ell_width;
+
+        // Dominanza diagonale, con i duplicati sulla diagonale sommati come nel prodotto
+        double diag = 0.0, off = 0.0;
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            if (csr->JA[j] == i) diag += csr->AS[j];
+            else off += fabs(csr->AS[j]);
+        }
+        if (len > 0 && fabs(diag) >= off) dominant++;
+
+        // Padding HLL: ogni riga occupa quanto la riga più lunga del suo blocco
+        if (i % hack_size == 0) {
+            int end = i + hack_size < M ? i + hack_size : M;
+            int block_max = 0;
+            for (int r = i; r < end; ++r) {
+                int l = csr->IRP[r + 1] - csr->IRP[r];
+                if (l > block_max) block_max = l;
+            }
+            stored += (long long)block_max * (end - i);
+        }
+    }
+
+    f->row_variance = M > 0 ? var / M : 0.0;
+    f->row_max = row_max;
+    f->empty_rows = empty;
+    f->bandwidth = csr_bandwidth(csr);
+    f->diag_dominance = M > 0 ? (double)dominant / M : 0.0;
+    f->hll_padding_ratio = csr->NZ > 0 ? (double)stored / csr->NZ : 1.0;
+
+    f->sell_sigma = SELL_SIGMA_FACTOR * hack_size;
+    f->sell_padding_ratio = f->hll_padding_ratio > 1.0
+                          ? sell_padding_ratio(csr, hack_size, f->sell_sigma)
+                          : f->hll_padding_ratio;
+
+    f->dia_diagonals = count_dia_diagonals(csr);
+    f->dia_fill_ratio = csr->NZ > 0 ? (double)f->dia_diagonals * M / csr->NZ : 1.0;
+
+    f->bcsr_fill_ratio = detect_bcsr_block(csr, &f->bcsr_r, &f->bcsr_c);
+
+    long long ell_nz = csr->NZ - coo;
+    f->hyb_coo_fraction = csr->NZ > 0 ? (double)coo / csr->NZ : 0.0;
+    f->hyb_ell_fill = ell_nz > 0 ? (double)ell_width * M / ell_nz : 1.0;
+
+    f->panel_width = panel_width > 0 ? panel_width : tiled_panel_width(detect_llc_size());
+    f->num_panels = csr->N > 0 ? (int)(((long long)csr->N + f->panel_width - 1) / f->panel_width) : 1;
+}
+
+FormatChoice select_spmv_format(const MatrixFeatures* f) {
+    const int nthreads = omp_get_max_threads();
+    FormatChoice choice;
+    choice.hack_size = f->hack_size;
+    choice.sigma = 0;
+    choice.block_r = 1;
+    choice.block_c = 1;
+    choice.ell_width = 0;
+    choice.panel_width = 0;
+    choice.max_fill = 0.0;
+    choice.jacobi = f->diag_dominance >= JACOBI_MIN_DOMINANCE;
+
+    double cv = f->row_mean > 0.0 ? sqrt(f->row_variance) / f->row_mean : 0.0;
+
+    if (f->NZ > 0 && f->dia_fill_ratio <= DIA_SELECT_MAX_FILL) {
+        choice.format = SPMV_FORMAT_DIA;
+        choice.max_fill = DIA_MAX_FILL;
+        choice.reason = "diagonali quasi piene, nessun indice memorizzato";
+    } else if (f->symmetric && f->M == f->N &&
+               (double)f->bandwidth * nthreads <= SYM_MAX_PARTIAL_RATIO * f->NZ) {
+        choice.format = SPMV_FORMAT_SYM;
+        choice.reason = "simmetrica con banda stretta, metà del traffico sulla matrice";
+    } else if (f->bcsr_r * f->bcsr_c > 1) {
+        // detect_bcsr_block sceglie un blocco solo se batte la CSR in byte per non-zero
+        choice.format = SPMV_FORMAT_BCSR;
+        choice.block_r = f->bcsr_r;
+        choice.block_c = f->bcsr_c;
+        choice.reason = "blocchi densi, un indice per blocco";
+    } else if (f->hll_padding_ratio <= HLL_MAX_PADDING_RATIO && cv <= HLL_MAX_ROW_CV &&
+               f->row_mean >= HLL_MIN_ROW_MEAN) {
+        choice.format = SPMV_FORMAT_HLL;
+        choice.reason = "righe regolari, padding HLL contenuto";
+    } else if (f->sell_padding_ratio <= HLL_MAX_PADDING_RATIO && f->row_mean >= HLL_MIN_ROW_MEAN) {
+        // L'ordinamento per lunghezza assorbe la variabilità delle righe
+        choice.format = SPMV_FORMAT_HLL;
+        choice.sigma = f->sell_sigma;
+        choice.reason = "padding contenuto con SELL-C-sigma";
+    } else if (f->hyb_ell_width > 0 && f->hyb_coo_fraction > 0.0 &&
+               f->hyb_coo_fraction <= HYB_MAX_COO_FRACTION && f->hyb_ell_fill <= HLL_MAX_PADDING_RATIO) {
+        // Poche righe lunghe: la parte ELL resta regolare, l'eccesso va in COO
+        choice.format = SPMV_FORMAT_HYB;
+        choice.ell_width = f->hyb_ell_width;
+        choice.reason = "poche righe lunghe, eccesso nella coda COO";
+    } else if (f->N > f->panel_width && f->bandwidth > f->panel_width &&
+               (long long)f->num_panels * f->M <= (long long)TILED_MAX_PANEL_RATIO * f->NZ) {
+        // Con banda entro un pannello la porzione di x letta da un thread è già locale
+        choice.format = SPMV_FORMAT_TILED;
+        choice.panel_width = f->panel_width;
+        choice.reason = "x oltre la LLC e accessi sparsi su tutta la riga";
+    } else if (f->hll_padding_ratio > HLL_MAX_PADDING_RATIO) {
+        choice.format = SPMV_FORMAT_CSR;
+        choice.reason = "padding HLL eccessivo";
+    } else {
+        choice.format = SPMV_FORMAT_CSR;
+        choice.reason = "righe corte o irregolari";
+    }
+
+    switch (choice.format) {
+    case SPMV_FORMAT_CSR: choice.kernel = spmv_csr_kernel_for(f->M, f->NZ, f->row_max, nthreads); break;
+    case SPMV_FORMAT_HLL: choice.kernel = SPMV_KERNEL_HLL_BLOCKS; break;
+    case SPMV_FORMAT_SYM: choice.kernel = SPMV_KERNEL_SYM_PARTIAL; break;
+    case SPMV_FORMAT_DIA: choice.kernel = SPMV_KERNEL_DIA_ROWS; break;
+    case SPMV_FORMAT_HYB: choice.kernel = SPMV_KERNEL_HYB_ELL_COO; break;
+    case SPMV_FORMAT_BCSR: choice.kernel = SPMV_KERNEL_BCSR_BLOCKS; break;
+    case SPMV_FORMAT_TILED: choice.kernel = SPMV_KERNEL_TILED_PANELS; break;
+    }
+
+    return choice;
+}
+
+spmv_plan_t* spmv_plan_create_for_choice(CSRMatrix* csr, HLLMatrix* hll, FormatChoice* choice) {
+    void* matrix;
+    switch (choice->format) {
+    case SPMV_FORMAT_HLL:
+        matrix = choice->sigma > 0 ? convert_csr_to_sell(csr, choice->hack_size, choice->sigma) : hll;
+        break;
+    case SPMV_FORMAT_SYM:
+        matrix = convert_csr_to_sym(csr, 0);
+        break;
+    case SPMV_FORMAT_DIA:
+        matrix = convert_csr_to_dia(csr, choice->max_fill);
+        break;
+    case SPMV_FORMAT_HYB:
+        matrix = convert_csr_to_hyb(csr, choice->ell_width);
+        break;
+    case SPMV_FORMAT_BCSR:
+        matrix = convert_csr_to_bcsr(csr, choice->block_r, choice->block_c);
+        break;
+    case SPMV_FORMAT_TILED:
+        matrix = convert_csr_to_tiled(csr, choice->panel_width, 0);
+        break;
+    default:
+        matrix = csr;
+        break;
+    }
+
+    if (!matrix) {
+        choice->format = SPMV_FORMAT_CSR;
+        choice->reason = "conversione rifiutata, ripiego sulla CSR";
+        matrix = csr;
+    }
+
+    spmv_plan_t* plan = spmv_plan_create(matrix, choice->format, 0);
+    plan->owns_matrix = matrix != (void*)csr && matrix != (void*)hll;
+    choice->kernel = plan->kernel;
+    return plan;
+}
+
+void print_matrix_features(const MatrixFeatures* f) {
+    printf("Features: %d x %d, NZ = %d\n", f->M, f->N, f->NZ);
+    printf("  nz/riga: media %.2f, dev. std %.2f, max %d, righe vuote %d\n",
+           f->row_mean, sqrt(f->row_variance), f->row_max, f->empty_rows);
+    printf("  bandwidth %d, diag. dominanza %.1f%%%s\n", f->bandwidth, 100.0 * f->diag_dominance,
+           f->symmetric ? ", simmetrica" : "");
+    printf("  padding HLL (HackSize %d): %.3f, SELL-C-sigma (sigma %d): %.3f\n",
+           f->hack_size, f->hll_padding_ratio, f->sell_sigma, f->sell_padding_ratio);
+    printf("  DIA: %d diagonali, fill %.3f; BCSR %dx%d: fill %.3f\n",
+           f->dia_diagonals, f->dia_fill_ratio, f->bcsr_r, f->bcsr_c, f->bcsr_fill_ratio);
+    printf("  HYB: ELL %d per riga, fill %.3f, COO %.1f%%; pannelli: %d da %d colonne\n",
+           f->hyb_ell_width, f->hyb_ell_fill, 100.0 * f->hyb_coo_fraction, f->num_panels, f->panel_width);
+}
+
+void print_format_choice(const FormatChoice* c) {
+    const char* name = c->format == SPMV_FORMAT_HLL && c->sigma > 0 ? "SELL-C-sigma" : spmv_format_name(c->format);
+    printf("Formato scelto: %s, kernel %s", name, spmv_kernel_name(c->kernel));
+    switch (c->format) {
+    case SPMV_FORMAT_HLL:
+        printf(", HackSize %d", c->hack_size);
+        if (c->sigma > 0) printf(", sigma %d", c->sigma);
+        break;
+    case SPMV_FORMAT_DIA: printf(", fill massimo %.2f", c->max_fill); break;
+    case SPMV_FORMAT_HYB: printf(", ELL %d per riga", c->ell_width); break;
+    case SPMV_FORMAT_BCSR: printf(", blocco %dx%d", c->block_r, c->block_c); break;
+    case SPMV_FORMAT_TILED: printf(", pannelli da %d colonne", c->panel_width); break;
+    default: break;
+    }
+    printf(" (%s)%s\n", c->reason, c->jacobi ? "; PCG Jacobi consigliato" : "");
+}
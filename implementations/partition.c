@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "include/CSR_Matrix.h"
+#include "include/partition.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Ricerca binaria lungo la diagonale `diag` del merge-path tra la lista
+ * delle fine-riga (IRP[1..M]) e la lista degli indici dei non-zero
+ * (0..NZ-1). Restituisce in `row`/`nz` la coordinata in cui la diagonale
+ * interseca il percorso: il thread che parte da qui ha davanti esattamente
+ * `diag` passi già consumati tra righe chiuse e non-zero elaborati.
+ */
+static void merge_path_search(const CSRMatrix* csr, long long diag, int* row, int* nz) {
+    const int* row_end = csr->IRP + 1;
+    long long lo = diag - csr->NZ > 0 ? diag - csr->NZ : 0;
+    long long hi = diag < csr->M ? diag : csr->M;
+
+    while (lo < hi) {
+        long long pivot = (lo + hi) / 2;
+        if (row_end[pivot] <= diag - pivot - 1) lo = pivot + 1;
+        else hi = pivot;
+    }
+
+    *row = (int)lo;
+    *nz = (int)(diag - lo);
+}
+
+CSRPartition* csr_merge_path_partition(const CSRMatrix* csr, int nthreads) {
+    if (nthreads < 1) nthreads = 1;
+
+    CSRPartition* part = malloc(sizeof(CSRPartition));
+    safe_malloc_check(part, "malloc CSRPartition");
+    part->nthreads = nthreads;
+    part->row_start = malloc((nthreads + 1) * sizeof(int));
+    part->nz_start = malloc((nthreads + 1) * sizeof(int));
+    part->carry_row = malloc(nthreads * sizeof(int));
+    part->carry_val = malloc(nthreads * sizeof(double));
+    safe_malloc_check(part->row_start, "malloc partition row_start");
+    safe_malloc_check(part->nz_start, "malloc partition nz_start");
+    safe_malloc_check(part->carry_row, "malloc partition carry_row");
+    safe_malloc_check(part->carry_val, "malloc partition carry_val");
+
+    long long total = (long long)csr->M + csr->NZ;
+    for (int t = 0; t <= nthreads; ++t) {
+        long long diag = total * t / nthreads;
+        merge_path_search(csr, diag, &part->row_start[t], &part->nz_start[t]);
+    }
+
+    return part;
+}
+
+void free_csr_partition(CSRPartition* part) {
+    if (!part) return;
+    free(part->row_start);
+    free(part->nz_start);
+    free(part->carry_row);
+    free(part->carry_val);
+    free(part);
+}
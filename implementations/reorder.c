@@ -0,0 +1,322 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/CSR_Matrix.h"
+#include "include/reorder.h"
+#include "include/arena.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Grafo non orientato di A + A^T senza self-loop, liste di adiacenza ordinate
+typedef struct {
+    int n;
+    int* xadj;               // n + 1 offset
+    int* adj;
+} Graph;
+
+static int compare_int(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static void build_symmetric_graph(const CSRMatrix* csr, Graph* g) {
+    const int n = csr->M;
+    int* count = calloc(n + 1, sizeof(int));
+    safe_malloc_check(count, "calloc graph degree");
+
+    for (int i = 0; i < n; ++i) {
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            int c = csr->JA[j];
+            if (c == i) continue;
+            count[i + 1]++;
+            count[c + 1]++;
+        }
+    }
+    for (int i = 0; i < n; ++i) count[i + 1] += count[i];
+
+    int* adj = malloc((size_t)count[n] * sizeof(int) + 1);
+    int* fill = malloc((n + 1) * sizeof(int));
+    safe_malloc_check(adj, "malloc graph adj");
+    safe_malloc_check(fill, "malloc graph fill");
+    memcpy(fill, count, (n + 1) * sizeof(int));
+
+    for (int i = 0; i < n; ++i) {
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            int c = csr->JA[j];
+            if (c == i) continue;
+            adj[fill[i]++] = c;
+            adj[fill[c]++] = i;
+        }
+    }
+
+    // Ordinamento e rimozione dei duplicati (a_ij e a_ji entrambi presenti)
+    int* xadj = fill;
+    xadj[0] = 0;
+    int out = 0;
+    for (int i = 0; i < n; ++i) {
+        int begin = count[i], end = count[i + 1];
+        qsort(adj + begin, end - begin, sizeof(int), compare_int);
+        for (int j = begin; j < end; ++j) {
+            if (j == begin || adj[j] != adj[j - 1]) adj[out++] = adj[j];
+        }
+        xadj[i + 1] = out;
+    }
+
+    free(count);
+    g->n = n;
+    g->xadj = xadj;
+    g->adj = adj;
+}
+
+static inline int degree(const Graph* g, int v) {
+    return g->xadj[v + 1] - g->xadj[v];
+}
+
+/**
+ * BFS a livelli da root sui soli nodi non ancora numerati (mark == 0).
+ * Scrive i nodi raggiunti in queue, restituisce il numero di nodi e
+ * l'eccentricità; *last_level punta all'inizio dell'ultimo livello.
+ * level[] viene ripristinato a -1 prima di uscire.
+ */
+static int bfs_levels(const Graph* g, const char* mark, int root, int* level, int* queue,
+                      int* count, int* last_level) {
+    int head = 0, tail = 0, depth = 0, level_begin = 0;
+    queue[tail++] = root;
+    level[root] = 0;
+
+    while (head < tail) {
+        int v = queue[head++];
+        if (level[v] > depth) {
+            depth = level[v];
+            level_begin = head - 1;
+        }
+        for (int j = g->xadj[v]; j < g->xadj[v + 1]; ++j) {
+            int w = g->adj[j];
+            if (mark[w] || level[w] >= 0) continue;
+            level[w] = level[v] + 1;
+            queue[tail++] = w;
+        }
+    }
+
+    for (int i = 0; i < tail; ++i) level[queue[i]] = -1;
+    *count = tail;
+    *last_level = level_begin;
+    return depth;
+}
+
+// Nodo pseudo-periferico (George-Liu) della componente connessa di start
+static int pseudo_peripheral_node(const Graph* g, const char* mark, int start, int* level, int* queue) {
+    int root = start, count, last;
+    int ecc = bfs_levels(g, mark, root, level, queue, &count, &last);
+
+    for (;;) {
+        int candidate = queue[last];
+        for (int i = last + 1; i < count; ++i) {
+            if (degree(g, queue[i]) < degree(g, candidate)) candidate = queue[i];
+        }
+        int candidate_ecc = bfs_levels(g, mark, candidate, level, queue, &count, &last);
+        if (candidate_ecc <= ecc) break;
+        root = candidate;
+        ecc = candidate_ecc;
+    }
+    return root;
+}
+
+typedef struct {
+    int degree;
+    int node;
+} NodeDegree;
+
+// Grado crescente, a parità di grado per indice di nodo
+static int compare_node_degree(const void* a, const void* b) {
+    const NodeDegree* na = a;
+    const NodeDegree* nb = b;
+    if (na->degree != nb->degree) return na->degree - nb->degree;
+    return na->node - nb->node;
+}
+
+Reordering* rcm_reordering(const CSRMatrix* csr) {
+    if (csr->M != csr->N) {
+        printf("RCM richiede una matrice quadrata (%d x %d)\n", csr->M, csr->N);
+        return NULL;
+    }
+
+    const int n = csr->M;
+    Graph g;
+    build_symmetric_graph(csr, &g);
+
+    int* order = malloc((n + 1) * sizeof(int));
+    int* level = malloc((n + 1) * sizeof(int));
+    int* queue = malloc((n + 1) * sizeof(int));
+    char* mark = calloc(n + 1, 1);
+    safe_malloc_check(order, "malloc RCM order");
+    safe_malloc_check(level, "malloc RCM level");
+    safe_malloc_check(queue, "malloc RCM queue");
+    safe_malloc_check(mark, "calloc RCM mark");
+    for (int i = 0; i < n; ++i) level[i] = -1;
+
+    int max_degree = 0;
+    for (int i = 0; i < n; ++i) {
+        if (degree(&g, i) > max_degree) max_degree = degree(&g, i);
+    }
+    NodeDegree* children = malloc((max_degree + 1) * sizeof(NodeDegree));
+    safe_malloc_check(children, "malloc RCM children");
+
+    // Cuthill-McKee componente per componente, vicini in ordine di grado crescente
+    int numbered = 0, next_start = 0;
+    while (numbered < n) {
+        while (mark[next_start]) next_start++;
+        int root = pseudo_peripheral_node(&g, mark, next_start, level, queue);
+
+        int head = numbered;
+        order[numbered++] = root;
+        mark[root] = 1;
+        while (head < numbered) {
+            int v = order[head++];
+            int nc = 0;
+            for (int j = g.xadj[v]; j < g.xadj[v + 1]; ++j) {
+                int w = g.adj[j];
+                if (mark[w]) continue;
+                mark[w] = 1;
+                children[nc].degree = degree(&g, w);
+                children[nc].node = w;
+                nc++;
+            }
+            qsort(children, nc, sizeof(NodeDegree), compare_node_degree);
+            for (int c = 0; c < nc; ++c) order[numbered++] = children[c].node;
+        }
+    }
+
+    Reordering* r = malloc(sizeof(Reordering));
+    safe_malloc_check(r, "malloc Reordering");
+    r->n = n;
+    r->perm = malloc((n + 1) * sizeof(int));
+    r->iperm = malloc((n + 1) * sizeof(int));
+    safe_malloc_check(r->perm, "malloc RCM perm");
+    safe_malloc_check(r->iperm, "malloc RCM iperm");
+
+    // Inversione dell'ordine Cuthill-McKee
+    for (int i = 0; i < n; ++i) {
+        r->perm[i] = order[n - 1 - i];
+        r->iperm[r->perm[i]] = i;
+    }
+
+    free(children);
+    free(mark);
+    free(queue);
+    free(level);
+    free(order);
+    free(g.xadj);
+    free(g.adj);
+    return r;
+}
+
+void free_reordering(Reordering* r) {
+    if (!r) return;
+    free(r->perm);
+    free(r->iperm);
+    free(r);
+}
+
+typedef struct {
+    int col;
+    double val;
+} ColumnValue;
+
+static int compare_column_value(const void* a, const void* b) {
+    const ColumnValue* ca = a;
+    const ColumnValue* cb = b;
+    return (ca->col > cb->col) - (ca->col < cb->col);
+}
+
+CSRMatrix* permute_csr_symmetric(const CSRMatrix* csr, const Reordering* r) {
+    const int M = csr->M;
+
+    CSRMatrix* mat = spmv_malloc(sizeof(CSRMatrix));
+    safe_malloc_check(mat, "malloc CSRMatrix");
+    mat->M = M;
+    mat->N = csr->N;
+    mat->NZ = csr->NZ;
+    mat->IRP = spmv_malloc((M + 1) * sizeof(int));
+    mat->JA = spmv_malloc((size_t)csr->NZ * sizeof(int));
+    mat->AS = spmv_malloc((size_t)csr->NZ * sizeof(double));
+    safe_malloc_check(mat->IRP, "malloc permuted IRP");
+    safe_malloc_check(mat->JA, "malloc permuted JA");
+    safe_malloc_check(mat->AS, "malloc permuted AS");
+
+    mat->IRP[0] = 0;
+    for (int i = 0; i < M; ++i) {
+        int old = r->perm[i];
+        mat->IRP[i + 1] = mat->IRP[i] + csr->IRP[old + 1] - csr->IRP[old];
+    }
+
+    int max_len = 0;
+    for (int i = 0; i < M; ++i) {
+        int len = csr->IRP[i + 1] - csr->IRP[i];
+        if (len > max_len) max_len = len;
+    }
+
+    #pragma omp parallel
+    {
+        ColumnValue* row = malloc((max_len + 1) * sizeof(ColumnValue));
+        safe_malloc_check(row, "malloc permuted row");
+
+        #pragma omp for schedule(guided, 64)
+        for (int i = 0; i < M; ++i) {
+            int old = r->perm[i];
+            int len = 0;
+            for (int j = csr->IRP[old]; j < csr->IRP[old + 1]; ++j, ++len) {
+                row[len].col = r->iperm[csr->JA[j]];
+                row[len].val = csr->AS[j];
+            }
+            qsort(row, len, sizeof(ColumnValue), compare_column_value);
+            for (int k = 0; k < len; ++k) {
+                mat->JA[mat->IRP[i] + k] = row[k].col;
+                mat->AS[mat->IRP[i] + k] = row[k].val;
+            }
+        }
+        free(row);
+    }
+
+    return mat;
+}
+
+void permute_vector(const Reordering* r, const double* v, double* out) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < r->n; ++i) out[i] = v[r->perm[i]];
+}
+
+void unpermute_vector(const Reordering* r, const double* v, double* out) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < r->n; ++i) out[r->perm[i]] = v[i];
+}
+
+int csr_bandwidth(const CSRMatrix* csr) {
+    int bandwidth = 0;
+    #pragma omp parallel for schedule(static) reduction(max:bandwidth)
+    for (int i = 0; i < csr->M; ++i) {
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            int dist = csr->JA[j] > i ? csr->JA[j] - i : i - csr->JA[j];
+            if (dist > bandwidth) bandwidth = dist;
+        }
+    }
+    return bandwidth;
+}
+
+long long csr_profile(const CSRMatrix* csr) {
+    long long profile = 0;
+    #pragma omp parallel for schedule(static) reduction(+:profile)
+    for (int i = 0; i < csr->M; ++i) {
+        int first = i;
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; ++j) {
+            if (csr->JA[j] < first) first = csr->JA[j];
+        }
+        profile += i - first;
+    }
+    return profile;
+}
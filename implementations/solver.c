@@ -0,0 +1,364 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/calculus.h"
+#include "include/spmv_plan.h"
+#include "include/solver.h"
+#include "include/arena.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Passate sui vettori per iterazione, in double letti + scritti per elemento
+#define CG_VECTOR_STREAMS 9      // x, p, r, q -> x, r; poi z, p -> p
+#define PCG_VECTOR_STREAMS 11    // in più: inv_diag letto, z scritto
+#define POWER_VECTOR_STREAMS 3   // x, q -> x
+
+static size_t plan_spmv_bytes(const spmv_plan_t* plan) {
+    const size_t vectors = ((size_t)plan->N + plan->M) * sizeof(double);
+    switch (plan->format) {
+    case SPMV_FORMAT_HLL: {
+        const HLLMatrix* hll = plan->hll;
+        size_t slots = (size_t)hll->hack_offset[hll->num_blocks];
+        size_t bytes = slots * (sizeof(double) + sizeof(int)) + vectors;
+        if (hll->perm) bytes += (size_t)hll->M * sizeof(int);
+        return bytes;
+    }
+    case SPMV_FORMAT_SYM: {
+        // Buffer parziali scritti e poi riletti nella riduzione
+        const CSRSymMatrix* sym = plan->sym;
+        return (size_t)sym->lower.NZ * (sizeof(double) + sizeof(int)) + ((size_t)sym->lower.M + 1) * sizeof(int) +
+               (size_t)sym->partial_offset[sym->nthreads] * 2 * sizeof(double) + vectors;
+    }
+    case SPMV_FORMAT_DIA:
+        return (size_t)plan->dia->num_diags * plan->dia->M * sizeof(double) + vectors;
+    case SPMV_FORMAT_HYB: {
+        const HYBMatrix* hyb = plan->hyb;
+        return (size_t)hyb->ell_width * hyb->M * (sizeof(double) + sizeof(int)) +
+               (size_t)hyb->coo_nz * (sizeof(double) + 2 * sizeof(int)) + vectors;
+    }
+    case SPMV_FORMAT_BCSR: {
+        const BCSRMatrix* bcsr = plan->bcsr;
+        return (size_t)bcsr->NBZ * ((size_t)bcsr->R * bcsr->C * sizeof(double) + sizeof(int)) +
+               ((size_t)bcsr->MB + 1) * sizeof(int) + vectors;
+    }
+    case SPMV_FORMAT_TILED: {
+        // Ogni riga memorizzata legge row_idx e row_ptr e aggiorna y (lettura + scrittura)
+        const CSRTiledMatrix* tiled = plan->tiled;
+        return (size_t)tiled->NZ * (sizeof(double) + sizeof(int)) +
+               (size_t)tiled->num_rows * (2 * sizeof(int) + 2 * sizeof(double)) + vectors;
+    }
+    default: {
+        const CSRMatrix* csr = plan->csr;
+        return (size_t)csr->NZ * (sizeof(double) + sizeof(int)) + ((size_t)csr->M + 1) * sizeof(int) + vectors;
+    }
+    }
+}
+
+SolverWorkspace* solver_workspace_create(spmv_plan_t* plan) {
+    int M = plan->M;
+    int N = plan->N;
+    if (M != N) {
+        printf("Solutori: matrice non quadrata (%d x %d)\n", M, N);
+        return NULL;
+    }
+
+    SolverWorkspace* ws = malloc(sizeof(SolverWorkspace));
+    safe_malloc_check(ws, "malloc SolverWorkspace");
+    ws->plan = plan;
+    ws->n = M;
+    ws->r = spmv_malloc((size_t)M * sizeof(double));
+    ws->z = spmv_malloc((size_t)M * sizeof(double));
+    ws->p = spmv_malloc((size_t)M * sizeof(double));
+    ws->q = spmv_malloc((size_t)M * sizeof(double));
+    safe_malloc_check(ws->r, "malloc solver r");
+    safe_malloc_check(ws->z, "malloc solver z");
+    safe_malloc_check(ws->p, "malloc solver p");
+    safe_malloc_check(ws->q, "malloc solver q");
+    ws->inv_diag = NULL;
+    ws->spmv_bytes = plan_spmv_bytes(plan);
+    return ws;
+}
+
+void solver_workspace_destroy(SolverWorkspace* ws) {
+    if (!ws) return;
+    spmv_free(ws->r);
+    spmv_free(ws->z);
+    spmv_free(ws->p);
+    spmv_free(ws->q);
+    spmv_free(ws->inv_diag);
+    free(ws);
+}
+
+// y = A x con il kernel, il livello SIMD e la partizione del piano, più il prodotto scalare richiesto
+static double spmv_dot(SolverWorkspace* ws, const double* x, double* y, SpmvDot dot) {
+    return spmv_plan_execute_dot(ws->plan, x, y, dot);
+}
+
+// a_ii di una CSR (somma dei duplicati sulla diagonale)
+static void csr_diagonal(const CSRMatrix* csr, double* d) {
+    #pragma omp parallel for schedule(guided, 64)
+    for (int i = 0; i < csr->M; i++) {
+        double diag = 0.0;
+        for (int j = csr->IRP[i]; j < csr->IRP[i + 1]; j++) {
+            if (csr->JA[j] == i) diag += csr->AS[j];
+        }
+        d[i] = diag;
+    }
+}
+
+// 1 / a_ii (somma dei duplicati sulla diagonale); righe con a_ii == 0 non precondizionate
+static void compute_inv_diag(SolverWorkspace* ws) {
+    const spmv_plan_t* plan = ws->plan;
+    double* d = ws->inv_diag;
+
+    switch (plan->format) {
+    case SPMV_FORMAT_HLL: {
+        const HLLMatrix* hll = plan->hll;
+        #pragma omp parallel for schedule(guided, 8)
+        for (int b = 0; b < hll->num_blocks; b++) {
+            const int rows = hll->blocks[b].rows_in_block;
+            const int max_nz = hll->blocks[b].max_nz_per_row;
+            const int* JA = hll->JA + hll->hack_offset[b];
+            const double* AS = hll->AS + hll->hack_offset[b];
+            for (int s = 0; s < rows; s++) {
+                const int row = hll->perm ? hll->perm[b * hll->HackSize + s] : b * hll->HackSize + s;
+                double diag = 0.0;
+                // Il padding vale 0.0, quindi non altera la somma
+                for (int k = 0; k < max_nz; k++) {
+                    if (JA[k * rows + s] == row) diag += AS[k * rows + s];
+                }
+                d[row] = diag;
+            }
+        }
+        break;
+    }
+    case SPMV_FORMAT_SYM:
+        // La diagonale è nel triangolo inferiore memorizzato
+        csr_diagonal(&plan->sym->lower, d);
+        break;
+    case SPMV_FORMAT_DIA: {
+        const DIAMatrix* dia = plan->dia;
+        memset(d, 0, (size_t)ws->n * sizeof(double));
+        for (int k = 0; k < dia->num_diags; k++) {
+            if (dia->offsets[k] == 0) memcpy(d, dia->data + (size_t)k * dia->M, (size_t)ws->n * sizeof(double));
+        }
+        break;
+    }
+    case SPMV_FORMAT_HYB: {
+        const HYBMatrix* hyb = plan->hyb;
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < hyb->M; i++) {
+            double diag = 0.0;
+            // Padding: colonna 0 e valore 0.0, non altera la somma
+            for (int k = 0; k < hyb->ell_width; k++) {
+                const size_t at = (size_t)k * hyb->M + i;
+                if (hyb->ell_JA[at] == i) diag += hyb->ell_AS[at];
+            }
+            d[i] = diag;
+        }
+        for (int k = 0; k < hyb->coo_nz; k++) {
+            if (hyb->coo_row[k] == hyb->coo_col[k]) d[hyb->coo_row[k]] += hyb->coo_val[k];
+        }
+        break;
+    }
+    case SPMV_FORMAT_BCSR: {
+        const BCSRMatrix* bcsr = plan->bcsr;
+        const int R = bcsr->R, C = bcsr->C;
+        #pragma omp parallel for schedule(guided, 16)
+        for (int br = 0; br < bcsr->MB; br++) {
+            for (int r = 0; r < R && br * R + r < bcsr->M; r++) {
+                const int row = br * R + r;
+                double diag = 0.0;
+                for (int k = bcsr->IRP[br]; k < bcsr->IRP[br + 1]; k++) {
+                    const int c = row - bcsr->JA[k] * C;
+                    if (c >= 0 && c < C) diag += bcsr->AS[(size_t)k * R * C + r * C + c];
+                }
+                d[row] = diag;
+            }
+        }
+        break;
+    }
+    case SPMV_FORMAT_TILED: {
+        // Una riga compare in più pannelli, ma sempre nella partizione dello stesso thread
+        const CSRTiledMatrix* tiled = plan->tiled;
+        #pragma omp parallel for schedule(static, 1)
+        for (int t = 0; t < tiled->nthreads; t++) {
+            for (int i = tiled->row_start[t]; i < tiled->row_start[t + 1]; i++) d[i] = 0.0;
+            for (int p = 0; p < tiled->num_panels; p++) {
+                const size_t block = (size_t)p * tiled->nthreads + t;
+                for (int k = tiled->panel_ptr[block]; k < tiled->panel_ptr[block + 1]; k++) {
+                    const int row = tiled->row_idx[k];
+                    for (int j = tiled->row_ptr[k]; j < tiled->row_ptr[k + 1]; j++) {
+                        if (tiled->JA[j] == row) d[row] += tiled->AS[j];
+                    }
+                }
+            }
+        }
+        break;
+    }
+    default:
+        csr_diagonal(plan->csr, d);
+        break;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < ws->n; i++) d[i] = d[i] != 0.0 ? 1.0 / d[i] : 1.0;
+}
+
+static void finish_stats(const SolverWorkspace* ws, SolverStats* stats, int iterations, double seconds, size_t bytes_per_iter) {
+    stats->kernel = spmv_plan_kernel_name(ws->plan);
+    stats->iterations = iterations;
+    stats->seconds = seconds;
+    stats->iter_per_sec = seconds > 0.0 ? iterations / seconds : 0.0;
+    stats->gbytes_per_sec = seconds > 0.0 ? (double)bytes_per_iter * iterations / seconds / 1e9 : 0.0;
+}
+
+/**
+ * CG / PCG. Per iterazione: q = A p con <p, q> fuso, una passata che
+ * aggiorna x, r (e z = D^-1 r) accumulando <r, r> e <r, z>, una passata
+ * per p = z + beta p. Senza precondizionatore z coincide con r.
+ */
+static int conjugate_gradient(SolverWorkspace* ws, const double* b, double* x, double tol, int max_iter,
+                              const double* inv_diag, SolverStats* stats) {
+    const int n = ws->n;
+    double* r = ws->r;
+    double* z = inv_diag ? ws->z : ws->r;
+    double* p = ws->p;
+    double* q = ws->q;
+
+    stats->converged = 0;
+    stats->eigenvalue = 0.0;
+    double start = omp_get_wtime();
+
+    // r = b - A x, z = D^-1 r, p = z
+    spmv_dot(ws, x, q, SPMV_DOT_NONE);
+    double bb = 0.0, rr = 0.0, rz = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:bb, rr, rz)
+    for (int i = 0; i < n; i++) {
+        r[i] = b[i] - q[i];
+        if (inv_diag) z[i] = inv_diag[i] * r[i];
+        p[i] = z[i];
+        bb += b[i] * b[i];
+        rr += r[i] * r[i];
+        rz += r[i] * z[i];
+    }
+    const double bnorm = bb > 0.0 ? sqrt(bb) : 1.0;
+    stats->residual = sqrt(rr) / bnorm;
+
+    int k = 0;
+    while (k < max_iter && stats->residual >= tol) {
+        double pq = spmv_dot(ws, p, q, SPMV_DOT_XAX);
+        // <p, A p> <= 0 (o non finito): A non definita positiva
+        if (!(pq > 0.0) || !isfinite(pq)) break;
+        const double alpha = rz / pq;
+
+        double rr_new = 0.0, rz_new = 0.0;
+        #pragma omp parallel for schedule(static) reduction(+:rr_new, rz_new)
+        for (int i = 0; i < n; i++) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+            if (inv_diag) z[i] = inv_diag[i] * r[i];
+            rr_new += r[i] * r[i];
+            rz_new += r[i] * z[i];
+        }
+        k++;
+        stats->residual = sqrt(rr_new) / bnorm;
+        if (stats->residual < tol || !isfinite(stats->residual)) break;
+
+        const double beta = rz_new / rz;
+        rz = rz_new;
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+    }
+    stats->converged = stats->residual < tol;
+
+    const int streams = inv_diag ? PCG_VECTOR_STREAMS : CG_VECTOR_STREAMS;
+    finish_stats(ws, stats, k, omp_get_wtime() - start, ws->spmv_bytes + (size_t)streams * n * sizeof(double));
+    return stats->converged;
+}
+
+int solver_cg(SolverWorkspace* ws, const double* b, double* x, double tol, int max_iter, SolverStats* stats) {
+    return conjugate_gradient(ws, b, x, tol, max_iter, NULL, stats);
+}
+
+int solver_pcg_jacobi(SolverWorkspace* ws, const double* b, double* x, double tol, int max_iter, SolverStats* stats) {
+    if (!ws->inv_diag) {
+        ws->inv_diag = spmv_malloc((size_t)ws->n * sizeof(double));
+        safe_malloc_check(ws->inv_diag, "malloc solver inv_diag");
+        compute_inv_diag(ws);
+    }
+    return conjugate_gradient(ws, b, x, tol, max_iter, ws->inv_diag, stats);
+}
+
+/**
+ * Metodo delle potenze: q = A x con <q, q> fuso, poi una sola passata che
+ * calcola lambda = <x, A x> (x unitario) e normalizza x = q / ||q||.
+ */
+int solver_power_iteration(SolverWorkspace* ws, double* x, double tol, int max_iter, SolverStats* stats) {
+    const int n = ws->n;
+    double* q = ws->q;
+
+    stats->converged = 0;
+    stats->eigenvalue = 0.0;
+    stats->residual = INFINITY;
+    double start = omp_get_wtime();
+
+    double xx = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:xx)
+    for (int i = 0; i < n; i++) xx += x[i] * x[i];
+    if (xx == 0.0) {
+        printf("Metodo delle potenze: vettore iniziale nullo\n");
+        finish_stats(ws, stats, 0, 0.0, 0);
+        return 0;
+    }
+    const double scale = 1.0 / sqrt(xx);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++) x[i] *= scale;
+
+    int k = 0;
+    double lambda = 0.0;
+    while (k < max_iter) {
+        double qq = spmv_dot(ws, x, q, SPMV_DOT_YY);
+        k++;
+        // x nel nucleo di A: autovalore 0
+        if (qq == 0.0) {
+            lambda = 0.0;
+            stats->residual = 0.0;
+            break;
+        }
+        const double inv_norm = 1.0 / sqrt(qq);
+
+        double rayleigh = 0.0;
+        #pragma omp parallel for schedule(static) reduction(+:rayleigh)
+        for (int i = 0; i < n; i++) {
+            rayleigh += x[i] * q[i];
+            x[i] = q[i] * inv_norm;
+        }
+
+        stats->residual = fabs(rayleigh - lambda) / (rayleigh != 0.0 ? fabs(rayleigh) : 1.0);
+        lambda = rayleigh;
+        if (k > 1 && stats->residual < tol) break;
+    }
+    stats->eigenvalue = lambda;
+    stats->converged = stats->residual < tol;
+
+    finish_stats(ws, stats, k, omp_get_wtime() - start, ws->spmv_bytes + (size_t)POWER_VECTOR_STREAMS * n * sizeof(double));
+    return stats->converged;
+}
+
+void solver_print_stats(const char* name, const SolverStats* stats) {
+    printf("%s [%s]: %d iterazioni, %s, residuo %.3e, %.6lf s (%.1f it/s, %.2f GB/s)",
+           name, stats->kernel, stats->iterations, stats->converged ? "convergenza" : "NON convergente",
+           stats->residual, stats->seconds, stats->iter_per_sec, stats->gbytes_per_sec);
+    if (stats->eigenvalue != 0.0) printf(", lambda %.10g", stats->eigenvalue);
+    printf("\n");
+}
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/partition.h"
+#include "include/calculus.h"
+#include "include/spmv_plan.h"
+#include "include/numa_alloc.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static const char* kernel_names[] = { "csr-rows", "csr-merge-path", "hll-blocks", "sym-partial",
+                                      "dia-rows", "hyb-ell-coo", "bcsr-blocks", "tiled-panels" };
+static const char* format_names[] = { "CSR", "HLL", "SYM", "DIA", "HYB", "BCSR", "TILED" };
+
+// Blocchi HLL bilanciati sugli slot memorizzati (padding incluso) via hack_offset
+static void partition_hll_blocks(const HLLMatrix* hll, int nthreads, int* part_start) {
+    long long total = hll->hack_offset[hll->num_blocks];
+    int b = 0;
+    part_start[0] = 0;
+    for (int t = 1; t < nthreads; ++t) {
+        long long target = total * t / nthreads;
+        while (b < hll->num_blocks && hll->hack_offset[b] < target) b++;
+        part_start[t] = b;
+    }
+    part_start[nthreads] = hll->num_blocks;
+}
+
+// Righe [0, M) in nthreads intervalli uguali
+static void partition_rows_even(int M, int nthreads, int* part_start) {
+    for (int t = 0; t <= nthreads; ++t) part_start[t] = (int)((long long)M * t / nthreads);
+}
+
+SpmvKernel spmv_csr_kernel_for(int M, int NZ, int row_max, int nthreads) {
+    // La partizione merge-path fornisce già confini di riga bilanciati su
+    // righe + non-zero; il carry-out serve solo se una riga da sola supera
+    // metà del lavoro di un thread
+    long long share = ((long long)M + NZ) / nthreads;
+    return nthreads > 1 && row_max > share / 2 ? SPMV_KERNEL_CSR_MERGE_PATH : SPMV_KERNEL_CSR_ROWS;
+}
+
+const char* spmv_kernel_name(SpmvKernel kernel) {
+    return kernel_names[kernel];
+}
+
+const char* spmv_format_name(SpmvFormat format) {
+    return format_names[format];
+}
+
+spmv_plan_t* spmv_plan_create(void* matrix, SpmvFormat format, int nthreads) {
+    if (format == SPMV_FORMAT_SYM) nthreads = ((CSRSymMatrix*)matrix)->nthreads;
+    if (format == SPMV_FORMAT_TILED) nthreads = ((CSRTiledMatrix*)matrix)->nthreads;
+    if (nthreads <= 0) nthreads = omp_get_max_threads();
+
+    spmv_plan_t* plan = calloc(1, sizeof(spmv_plan_t));
+    safe_malloc_check(plan, "calloc spmv_plan_t");
+    plan->format = format;
+    plan->simd = detect_simd_level();
+    plan->csr_rows = csr_simd_rows_kernel(plan->simd);
+    plan->hll_blocks = hll_simd_blocks_kernel(plan->simd);
+    plan->nthreads = nthreads;
+    plan->part_start = malloc((nthreads + 1) * sizeof(int));
+    safe_malloc_check(plan->part_start, "malloc plan part_start");
+
+    switch (format) {
+    case SPMV_FORMAT_CSR: {
+        CSRMatrix* csr = matrix;
+        plan->csr = csr;
+        plan->M = csr->M;
+        plan->N = csr->N;
+
+        int max_row = 0;
+        for (int i = 0; i < csr->M; ++i) {
+            int len = csr->IRP[i + 1] - csr->IRP[i];
+            if (len > max_row) max_row = len;
+        }
+        plan->kernel = spmv_csr_kernel_for(csr->M, csr->NZ, max_row, nthreads);
+        plan->merge = csr_merge_path_partition(csr, nthreads);
+        if (plan->kernel == SPMV_KERNEL_CSR_ROWS) {
+            for (int t = 0; t <= nthreads; ++t) plan->part_start[t] = plan->merge->row_start[t];
+            free_csr_partition(plan->merge);
+            plan->merge = NULL;
+        }
+        break;
+    }
+    case SPMV_FORMAT_HLL:
+        plan->hll = matrix;
+        plan->M = plan->hll->M;
+        plan->N = plan->hll->N;
+        plan->kernel = SPMV_KERNEL_HLL_BLOCKS;
+        partition_hll_blocks(plan->hll, nthreads, plan->part_start);
+        break;
+    // Gli altri formati usano il proprio kernel parallelo; part_start sono le
+    // righe che quel kernel assegna a ogni thread (o, dove il kernel non le
+    // fissa, intervalli uguali) e servono al prodotto scalare fuso
+    case SPMV_FORMAT_SYM:
+        plan->sym = matrix;
+        plan->M = plan->N = plan->sym->lower.M;
+        plan->kernel = SPMV_KERNEL_SYM_PARTIAL;
+        for (int t = 0; t <= nthreads; ++t) plan->part_start[t] = plan->sym->row_start[t];
+        break;
+    case SPMV_FORMAT_DIA:
+        plan->dia = matrix;
+        plan->M = plan->dia->M;
+        plan->N = plan->dia->N;
+        plan->kernel = SPMV_KERNEL_DIA_ROWS;
+        partition_rows_even(plan->M, nthreads, plan->part_start);
+        break;
+    case SPMV_FORMAT_HYB:
+        plan->hyb = matrix;
+        plan->M = plan->hyb->M;
+        plan->N = plan->hyb->N;
+        plan->kernel = SPMV_KERNEL_HYB_ELL_COO;
+        partition_rows_even(plan->M, nthreads, plan->part_start);
+        break;
+    case SPMV_FORMAT_BCSR:
+        plan->bcsr = matrix;
+        plan->M = plan->bcsr->M;
+        plan->N = plan->bcsr->N;
+        plan->kernel = SPMV_KERNEL_BCSR_BLOCKS;
+        partition_rows_even(plan->M, nthreads, plan->part_start);
+        break;
+    case SPMV_FORMAT_TILED:
+        plan->tiled = matrix;
+        plan->M = plan->tiled->M;
+        plan->N = plan->tiled->N;
+        plan->kernel = SPMV_KERNEL_TILED_PANELS;
+        for (int t = 0; t <= nthreads; ++t) plan->part_start[t] = plan->tiled->row_start[t];
+        break;
+    }
+
+    // Avvia il pool di thread e fa scrivere a ogni thread i propri buffer di
+    // carry, così la prima execute non paga la creazione dei thread. Il
+    // first-touch di matrice e vettori è in spmv_plan_first_touch / numa_alloc_vector
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int t = omp_get_thread_num();
+        if (plan->merge && t < plan->merge->nthreads) {
+            plan->merge->carry_row[t] = 0;
+            plan->merge->carry_val[t] = 0.0;
+        }
+    }
+
+    return plan;
+}
+
+void spmv_plan_execute(spmv_plan_t* plan, const double* x, double* y) {
+    switch (plan->kernel) {
+    case SPMV_KERNEL_CSR_MERGE_PATH:
+        csr_merge_path_mat_per_vec(plan->csr, plan->merge, x, y);
+        return;
+    case SPMV_KERNEL_SYM_PARTIAL:
+        csr_sym_parallel_mat_per_vec(plan->sym, x, y);
+        return;
+    case SPMV_KERNEL_DIA_ROWS:
+        dia_parallel_mat_per_vec(plan->dia, x, y);
+        return;
+    case SPMV_KERNEL_HYB_ELL_COO:
+        hyb_parallel_mat_per_vec(plan->hyb, x, y);
+        return;
+    case SPMV_KERNEL_BCSR_BLOCKS:
+        bcsr_parallel_mat_per_vec(plan->bcsr, x, y);
+        return;
+    case SPMV_KERNEL_TILED_PANELS:
+        csr_tiled_parallel_mat_per_vec(plan->tiled, x, y);
+        return;
+    default:
+        break;
+    }
+
+    #pragma omp parallel num_threads(plan->nthreads)
+    {
+        // Se il runtime concede meno thread, ciascuno prende più partizioni
+        for (int t = omp_get_thread_num(); t < plan->nthreads; t += omp_get_num_threads()) {
+            if (plan->kernel == SPMV_KERNEL_CSR_ROWS) {
+                plan->csr_rows(plan->csr, plan->part_start[t], plan->part_start[t + 1], x, y);
+            } else {
+                plan->hll_blocks(plan->hll, plan->part_start[t], plan->part_start[t + 1], x, y);
+            }
+        }
+    }
+}
+
+// Prodotto scalare sulle righe memorizzate [rb, re); perm riporta le righe SELL all'ordine originale
+static double rows_dot(const int* perm, int rb, int re, const double* x, const double* y, SpmvDot dot) {
+    const double* u = dot == SPMV_DOT_XAX ? x : y;
+    double sum = 0.0;
+    if (perm) {
+        for (int r = rb; r < re; r++) sum += u[perm[r]] * y[perm[r]];
+    } else {
+        for (int i = rb; i < re; i++) sum += u[i] * y[i];
+    }
+    return sum;
+}
+
+double spmv_plan_execute_dot(spmv_plan_t* plan, const double* x, double* y, SpmvDot dot) {
+    if (dot == SPMV_DOT_NONE) {
+        spmv_plan_execute(plan, x, y);
+        return 0.0;
+    }
+
+    const int nthreads = plan->nthreads;
+    double result = 0.0;
+
+    // Kernel con una propria sincronizzazione interna (carry, buffer parziali,
+    // barriere per pannello): passata separata sulle righe della partizione
+    if (plan->kernel != SPMV_KERNEL_CSR_ROWS && plan->kernel != SPMV_KERNEL_HLL_BLOCKS) {
+        spmv_plan_execute(plan, x, y);
+        const int* row_start = plan->merge ? plan->merge->row_start : plan->part_start;
+        #pragma omp parallel num_threads(nthreads) reduction(+:result)
+        for (int t = omp_get_thread_num(); t < nthreads; t += omp_get_num_threads()) {
+            result += rows_dot(NULL, row_start[t], row_start[t + 1], x, y, dot);
+        }
+        return result;
+    }
+
+    #pragma omp parallel num_threads(nthreads) reduction(+:result)
+    for (int t = omp_get_thread_num(); t < nthreads; t += omp_get_num_threads()) {
+        const int pb = plan->part_start[t], pe = plan->part_start[t + 1];
+        if (plan->kernel == SPMV_KERNEL_CSR_ROWS) {
+            plan->csr_rows(plan->csr, pb, pe, x, y);
+            result += rows_dot(NULL, pb, pe, x, y, dot);
+        } else {
+            const HLLMatrix* hll = plan->hll;
+            plan->hll_blocks(hll, pb, pe, x, y);
+            long long rb = (long long)pb * hll->HackSize, re = (long long)pe * hll->HackSize;
+            result += rows_dot(hll->perm, (int)(rb < hll->M ? rb : hll->M), (int)(re < hll->M ? re : hll->M), x, y, dot);
+        }
+    }
+    return result;
+}
+
+const char* spmv_plan_kernel_name(const spmv_plan_t* plan) {
+    return spmv_kernel_name(plan->kernel);
+}
+
+void spmv_plan_destroy(spmv_plan_t* plan) {
+    if (!plan) return;
+    if (plan->owns_matrix) {
+        free_hll_matrix(plan->hll);
+        if (plan->sym) free_sym_matrix(plan->sym);
+        if (plan->dia) free_dia_matrix(plan->dia);
+        if (plan->hyb) free_hyb_matrix(plan->hyb);
+        if (plan->bcsr) free_bcsr_matrix(plan->bcsr);
+        if (plan->tiled) free_tiled_matrix(plan->tiled);
+    }
+    free_csr_partition(plan->merge);
+    free(plan->part_start);
+    free(plan);
+}
+
+void spmv_plan_print(const spmv_plan_t* plan) {
+    printf("SpMV plan: formato = %s, kernel = %s, simd = %s, threads = %d\n",
+           spmv_format_name(plan->format), spmv_plan_kernel_name(plan), simd_level_name(plan->simd), plan->nthreads);
+}
+
+void spmv_plan_row_start(const spmv_plan_t* plan, int* row_start) {
+    for (int t = 0; t <= plan->nthreads; ++t) {
+        if (plan->kernel == SPMV_KERNEL_CSR_MERGE_PATH) {
+            row_start[t] = plan->merge->row_start[t];
+        } else if (plan->kernel == SPMV_KERNEL_HLL_BLOCKS) {
+            long long row = (long long)plan->part_start[t] * plan->hll->HackSize;
+            row_start[t] = row < plan->hll->M ? (int)row : plan->hll->M;
+        } else {
+            row_start[t] = plan->part_start[t];
+        }
+    }
+}
+
+void spmv_plan_first_touch(spmv_plan_t* plan) {
+    if (plan->format == SPMV_FORMAT_HLL) {
+        numa_place_hll(plan->hll, plan->part_start, plan->nthreads);
+        return;
+    }
+    if (plan->format != SPMV_FORMAT_CSR) return;
+
+    int* row_start = malloc((plan->nthreads + 1) * sizeof(int));
+    safe_malloc_check(row_start, "malloc plan row_start");
+    spmv_plan_row_start(plan, row_start);
+    numa_place_csr(plan->csr, row_start, plan->nthreads);
+    free(row_start);
+}
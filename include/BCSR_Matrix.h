@@ -0,0 +1,34 @@
+#ifndef BCSR_MATRIX_H
+#define BCSR_MATRIX_H
+
+#include "CSR_Matrix.h"
+
+// Block CSR: blocchi densi R x C con un solo indice colonna per blocco
+typedef struct {
+    int M;                   // Righe scalari
+    int N;                   // Colonne scalari
+    int NZ;                  // Non-zero della matrice originale
+    int R;                   // Righe per blocco
+    int C;                   // Colonne per blocco
+    int MB;                  // Righe di blocco, ceil(M / R)
+    int NB;                  // Colonne di blocco, ceil(N / C)
+    int NBZ;                 // Blocchi memorizzati
+    int* IRP;                // Row pointer di blocco (MB + 1)
+    int* JA;                 // Colonna di blocco, crescente in ogni riga di blocco
+    double* AS;              // NBZ blocchi R x C row-major, zeri di riempimento inclusi
+} BCSRMatrix;
+
+// Blocchi candidati per il rilevamento automatico
+#define BCSR_NUM_CANDIDATES 4
+extern const int bcsr_candidates[BCSR_NUM_CANDIDATES][2];
+
+// Fill ratio: valori memorizzati (NBZ * R * C) / NZ, >= 1
+double bcsr_fill_ratio(const CSRMatrix* csr, int R, int C);
+// Sceglie il blocco con il minor traffico stimato per non-zero; 1x1 se nessuno
+// batte la CSR. Restituisce il fill ratio del blocco scelto
+double detect_bcsr_block(const CSRMatrix* csr, int* R, int* C);
+
+BCSRMatrix* convert_csr_to_bcsr(const CSRMatrix* csr, int R, int C);
+void free_bcsr_matrix(BCSRMatrix* mat);
+
+#endif
@@ -13,6 +13,15 @@ typedef struct {
 } CSRMatrix;
 
 CSRMatrix* load_matrix_market_to_csr(const char* filename);
+// Come sopra, ma un file simmetrico restituisce solo triangolo inferiore e diagonale
+CSRMatrix* load_matrix_market_lower(const char* filename, int* is_symmetric);
+// Legge solo il banner: 1 se il file dichiara una matrice simmetrica, 0 altrimenti
+int matrix_market_is_symmetric(const char* filename);
+// Assemblaggio parallelo da COO in memoria (indici 0-based): colonne ordinate
+// in ogni riga, duplicati sommati; con is_symmetric si espande la parte trasposta
+CSRMatrix* coo_to_csr(int M, int N, int nz, const int* rows, const int* cols,
+                      const double* vals, int is_symmetric);
+CSRMatrix* copy_csr_matrix(const CSRMatrix* csr);
 void free_csr_matrix(CSRMatrix* mat);
 void print_csr_matrix(const CSRMatrix* mat);
 #endif
@@ -0,0 +1,25 @@
+#ifndef DIA_MATRIX_H
+#define DIA_MATRIX_H
+
+#include "CSR_Matrix.h"
+
+// Oltre questo rapporto valori memorizzati / NZ il formato DIA non conviene
+#define DIA_MAX_FILL 2.0
+
+// Formato diagonale: ogni diagonale occupata è memorizzata per intero
+typedef struct {
+    int M;                   // Righe
+    int N;                   // Colonne
+    int NZ;                  // Non-zero della matrice originale
+    int num_diags;           // Diagonali memorizzate
+    int* offsets;            // Colonna - riga di ogni diagonale, crescente
+    double* data;            // num_diags * M: elemento (i, i + offsets[d]) in data[d * M + i]
+} DIAMatrix;
+
+// Numero di diagonali occupate (M + N - 1 possibili)
+int count_dia_diagonals(const CSRMatrix* csr);
+// NULL se num_diags * M / NZ supera max_fill
+DIAMatrix* convert_csr_to_dia(const CSRMatrix* csr, double max_fill);
+void free_dia_matrix(DIAMatrix* mat);
+
+#endif
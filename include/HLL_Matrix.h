@@ -1,6 +1,12 @@
 #ifndef HLL_MATRIX_H
 #define HLL_MATRIX_H
 
+#include <limits.h>
+#include <stdint.h>
+
+#define HLL_ALIGNMENT 64         // Allineamento (byte) dei buffer JA/AS contigui
+#define HLL_DEFAULT_HACKSIZE 32  // HackSize usato se non specificato (hack_size <= 0)
+
 typedef struct {
     int rows_in_block;       // Numero di righe nel blocco
     int max_nz_per_row;      // Max numero di non-zero per riga (padding ELLPACK)
@@ -11,15 +17,54 @@ typedef struct {
 typedef struct {
     int M;                   // Numero di righe della matrice originale
     int N;                   // Numero di colonne
+    int NZ;                  // Numero di non-zero effettivi (padding escluso)
     int HackSize;            // Numero di righe per blocco
     int num_blocks;          // Numero di blocchi totali
-    HLLBlock* blocks;        // Array di blocchi HLL
+    HLLBlock* blocks;        // Descrittori dei blocchi (JA/AS puntano nei buffer contigui)
+    int64_t* hack_offset;    // Offset del blocco b in JA/AS (num_blocks + 1 elementi); il
+                             // totale con padding può superare INT_MAX anche se NZ non lo fa
+    int* JA;                 // Indici colonna di tutti i blocchi, column-major per blocco
+    double* AS;              // Valori di tutti i blocchi (stessa disposizione di JA)
+    int* perm;               // SELL-C-sigma: riga originale della riga memorizzata r (NULL = identità)
 } HLLMatrix;
 
+// Descrittore degli indici di un blocco nello stream compatto
+#define HLL_INDEX_FULL INT_MIN   // stride riservato: il blocco usa il JA completo
+
+typedef struct {
+    int64_t offset;          // Offset in HLLCompactIndex.data
+    int stride;              // Colonna = base[j] + riga_locale * stride, o HLL_INDEX_FULL
+} HLLIndexDesc;
+
+// Stream di indici compatto: i blocchi con colonne base + offset (stencil)
+// memorizzano solo max_nz basi, gli altri l'intero JA del blocco
+typedef struct {
+    int num_blocks;
+    int compact_blocks;      // Blocchi codificati come base + stride
+    HLLIndexDesc* desc;      // num_blocks descrittori
+    int* data;               // Basi (blocchi compatti) o JA (blocchi completi)
+    long long data_len;      // Interi in data
+} HLLCompactIndex;
+
 // Funzione per liberare la memoria di una matrice HLL
 void free_hll_matrix(HLLMatrix* hll);
 
-// Funzione per caricare una matrice .mtx in formato HLL column-major
-HLLMatrix* convert_csr_to_hll(const CSRMatrix* csr);
+// Funzione per convertire una matrice CSR in formato HLL column-major con blocchi di hack_size righe
+HLLMatrix* convert_csr_to_hll(const CSRMatrix* csr, int hack_size);
+
+// SELL-C-sigma: righe ordinate per lunghezza in finestre di sigma righe prima
+// della suddivisione in blocchi; i kernel scrivono y nell'ordine originale
+HLLMatrix* convert_csr_to_sell(const CSRMatrix* csr, int hack_size, int sigma);
+int* sell_row_permutation(const CSRMatrix* csr, int hack_size, int sigma);
+
+// Rapporto slot memorizzati / NZ (1.0 = nessun padding)
+double hll_padding_ratio(const HLLMatrix* hll);
+// Rapporto di padding ottenibile con SELL-C-sigma, senza costruire la matrice (sigma 0 = HLL)
+double sell_padding_ratio(const CSRMatrix* csr, int hack_size, int sigma);
+
+// Rileva i blocchi con colonne a passo costante e costruisce lo stream compatto;
+// csr è la sorgente di hll, da cui si leggono le lunghezze di riga
+HLLCompactIndex* hll_build_compact_index(const HLLMatrix* hll, const CSRMatrix* csr);
+void free_hll_compact_index(HLLCompactIndex* index);
 
 #endif // HLL_MATRIX_H
@@ -0,0 +1,31 @@
+#ifndef HYB_MATRIX_H
+#define HYB_MATRIX_H
+
+#include "CSR_Matrix.h"
+
+/**
+ * Formato ibrido ELL + COO: i primi ell_width elementi di ogni riga vanno
+ * in una ELLPACK column-major senza permutazioni, gli elementi in eccesso
+ * delle righe lunghe in una coda COO ordinata per riga. Il padding resta
+ * limitato alla lunghezza tipica anziché alla riga più lunga.
+ */
+typedef struct {
+    int M;
+    int N;
+    int NZ;
+    int ell_width;           // Elementi per riga nella parte ELL
+    int* ell_JA;             // ell_width * M, elemento k della riga i in [k * M + i]
+    double* ell_AS;          // Padding: colonna 0, valore 0.0
+    int coo_nz;              // Elementi nella coda COO
+    int* coo_row;            // Righe non decrescenti
+    int* coo_col;
+    double* coo_val;
+} HYBMatrix;
+
+// Larghezza ELL: la massima K per cui almeno un terzo delle righe ha >= K elementi
+int hyb_select_ell_width(const CSRMatrix* csr);
+// ell_width <= 0: scelta automatica con hyb_select_ell_width
+HYBMatrix* convert_csr_to_hyb(const CSRMatrix* csr, int ell_width);
+void free_hyb_matrix(HYBMatrix* mat);
+
+#endif
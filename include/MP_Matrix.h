@@ -0,0 +1,58 @@
+#ifndef MP_MATRIX_H
+#define MP_MATRIX_H
+
+#include <stdint.h>
+#include "CSR_Matrix.h"
+#include "HLL_Matrix.h"
+
+// Escape nello stream di delta: seguono due parole (alta, bassa) con la colonna a 32 bit
+#define DELTA16_ESCAPE INT16_MIN
+#define DELTA16_MAX INT16_MAX
+
+// Codifica degli indici colonna nei formati a precisione mista
+typedef enum {
+    MP_INDEX_INT32 = 0,          // Indici int a 32 bit (8 byte/nz con valori float)
+    MP_INDEX_DELTA16             // Delta a 16 bit con escape (fino a 6 byte/nz)
+} MPIndexMode;
+
+// CSR con valori float (accumulo in double) e indici opzionalmente compressi
+typedef struct {
+    int M;                   // Righe
+    int N;                   // Colonne
+    int NZ;                  // Non-zero count
+    MPIndexMode index_mode;
+    int* IRP;                // Row pointer su AS (M + 1)
+    float* AS;               // Valori in singola precisione
+    int* JA;                 // MP_INDEX_INT32: indici colonna
+    int* IDXP;               // MP_INDEX_DELTA16: row pointer sullo stream JD (M + 1)
+    int16_t* JD;             // MP_INDEX_DELTA16: delta rispetto alla colonna precedente
+                             // (la prima della riga i è relativa a i)
+} CSRMatrixMP;
+
+// HLL con valori float e, per ogni blocco, delta a 16 bit (colonna - riga)
+// se tutti rientrano, altrimenti indici a 32 bit (escape a livello di blocco)
+typedef struct {
+    int M;
+    int N;
+    int NZ;
+    int HackSize;
+    int num_blocks;
+    int64_t* hack_offset;    // Offset del blocco b in AS/JD (num_blocks + 1)
+    int64_t* wide_offset;    // Offset del blocco b in JA (num_blocks + 1); vuoto se a 16 bit
+    float* AS;               // Valori, layout column-major come HLLMatrix
+    int16_t* JD;             // Delta colonna - riga globale dei soli blocchi a 16 bit, dal
+                             // blocco b in hack_offset[b] - wide_offset[b]
+    int* JA;                 // Indici a 32 bit dei soli blocchi con delta troppo larghi
+    int* perm;               // Permutazione SELL-C-sigma copiata dalla sorgente (NULL = identità)
+} HLLMatrixMP;
+
+CSRMatrixMP* convert_csr_to_mp(const CSRMatrix* csr, MPIndexMode index_mode);
+HLLMatrixMP* convert_hll_to_mp(const HLLMatrix* hll);
+void free_csr_mp_matrix(CSRMatrixMP* mat);
+void free_hll_mp_matrix(HLLMatrixMP* mat);
+
+// Byte per non-zero effettivamente memorizzati (valori + indici, padding incluso)
+double csr_mp_bytes_per_nz(const CSRMatrixMP* mat);
+double hll_mp_bytes_per_nz(const HLLMatrixMP* mat);
+
+#endif
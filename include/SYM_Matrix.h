@@ -0,0 +1,41 @@
+#ifndef SYM_MATRIX_H
+#define SYM_MATRIX_H
+
+#include "CSR_Matrix.h"
+
+/**
+ * Matrice simmetrica memorizzata come triangolo inferiore + diagonale
+ * (JA[j] <= i in ogni riga): ogni elemento fuori diagonale contribuisce
+ * sia a y[i] sia a y[JA[j]], dimezzando il traffico sulla matrice.
+ *
+ * Nel kernel parallelo il thread t possiede le righe row_start[t] ..
+ * row_start[t+1] (bilanciate sui non-zero): gli aggiornamenti trasposti
+ * verso righe precedenti a row_start[t] finiscono nel suo buffer privato
+ * partial + partial_offset[t], che copre solo le righe
+ * [partial_lo[t], row_start[t]), dove partial_lo[t] è la colonna minima
+ * toccata dal thread. Per la riduzione le righe coperte da almeno un
+ * buffer sono divise in segmenti con lo stesso insieme di thread: i
+ * segmenti sono disgiunti, quindi si sommano in parallelo senza atomiche.
+ */
+typedef struct {
+    CSRMatrix lower;         // M x M, triangolo inferiore con diagonale
+    int nthreads;
+    int* row_start;          // nthreads + 1
+    int* partial_lo;         // nthreads, prima riga del buffer privato di t
+    long long* partial_offset; // nthreads + 1, offset dei buffer privati in partial
+    double* partial;         // Buffer y parziali dei thread
+    int num_segments;        // Segmenti di riduzione
+    int* segment_bounds;     // num_segments + 1: il segmento k copre [bounds[k], bounds[k+1])
+    int* segment_ptr;        // num_segments + 1, offset in segment_threads
+    int* segment_threads;    // Thread i cui buffer coprono ciascun segmento
+} CSRSymMatrix;
+
+// Prende possesso di lower (che deve contenere solo j <= i); nthreads <= 0: massimo OpenMP
+CSRSymMatrix* build_sym_matrix(CSRMatrix* lower, int nthreads);
+// Estrae il triangolo inferiore da una CSR completa di una matrice simmetrica
+CSRSymMatrix* convert_csr_to_sym(const CSRMatrix* csr, int nthreads);
+// Carica un file Matrix Market simmetrico senza espansione; NULL se non simmetrico
+CSRSymMatrix* load_matrix_market_to_sym(const char* filename, int nthreads);
+void free_sym_matrix(CSRSymMatrix* mat);
+
+#endif
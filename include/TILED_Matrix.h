@@ -0,0 +1,51 @@
+#ifndef TILED_MATRIX_H
+#define TILED_MATRIX_H
+
+#include "CSR_Matrix.h"
+
+// Frazione della LLC riservata al pannello di x; il resto serve allo stream di JA/AS e a y
+#define TILED_LLC_FRACTION 0.5
+// Pannelli più stretti moltiplicano solo il costo degli IRP
+#define TILED_MIN_PANEL_WIDTH 4096
+
+// Oltre num_panels * M > TILED_MAX_PANEL_RATIO * NZ la maggior parte delle righe
+// di un pannello è vuota o quasi: conviene la CSR normale
+#define TILED_MAX_PANEL_RATIO 4
+
+/**
+ * CSR a pannelli verticali: le colonne sono divise in num_panels strisce
+ * di panel_width colonne e ogni pannello memorizza solo le sue righe non
+ * vuote, di seguito al pannello precedente. Il kernel scorre i pannelli in
+ * ordine, così la porzione di x letta da tutti i thread resta in LLC per
+ * l'intero pannello; y accumula i contributi parziali.
+ *
+ * La riga memorizzata k ha indice row_idx[k] e non-zero JA/AS[row_ptr[k] ..
+ * row_ptr[k + 1]). Le righe sono divise tra i thread in row_start,
+ * bilanciate sui non-zero; quelle del thread t nel pannello p sono
+ * [panel_ptr[p * nthreads + t], panel_ptr[p * nthreads + t + 1]).
+ * Memoria aggiuntiva: O(righe non vuote + num_panels * nthreads).
+ */
+typedef struct {
+    int M;
+    int N;
+    int NZ;
+    int panel_width;
+    int num_panels;
+    int num_rows;            // Righe memorizzate, sommate su tutti i pannelli
+    int* panel_ptr;          // num_panels * nthreads + 1, offset in row_idx
+    int* row_idx;            // num_rows, indice di riga globale
+    int* row_ptr;            // num_rows + 1, offset in JA/AS
+    int* JA;                 // Colonne globali, pannello per pannello
+    double* AS;
+    int nthreads;
+    int* row_start;          // nthreads + 1
+} CSRTiledMatrix;
+
+// Larghezza del pannello tale che x[panel] occupi TILED_LLC_FRACTION della LLC
+int tiled_panel_width(size_t llc_bytes);
+// panel_width <= 0: tiled_panel_width(detect_llc_size()); nthreads <= 0: massimo OpenMP.
+// NULL se num_panels * M supera TILED_MAX_PANEL_RATIO * NZ
+CSRTiledMatrix* convert_csr_to_tiled(const CSRMatrix* csr, int panel_width, int nthreads);
+void free_tiled_matrix(CSRTiledMatrix* mat);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 64
+#define ARENA_DEFAULT_CHUNK (64UL << 20)   // 64 MB per chunk
+#define ARENA_HUGE_PAGE (2UL << 20)
+
+// Politica delle pagine dei chunk
+typedef enum {
+    ARENA_PAGES_DEFAULT = 0,     // Politica THP di sistema
+    ARENA_PAGES_HUGE,            // MAP_HUGETLB, altrimenti madvise(MADV_HUGEPAGE) su chunk allineati a 2 MB
+    ARENA_PAGES_SMALL            // madvise(MADV_NOHUGEPAGE): baseline a pagine da 4 KB
+} ArenaPages;
+
+/**
+ * Arena a chunk per i buffer di matrici e vettori.
+ *
+ * Ogni allocazione è allineata a ARENA_ALIGNMENT byte e ricavata con un
+ * semplice bump pointer da chunk mmap; la memoria si rilascia tutta
+ * insieme con arena_reset, che conserva un unico chunk grande quanto il
+ * picco raggiunto, così la matrice successiva non ripaga mmap e page fault
+ * iniziali. La politica ArenaPages sceglie pagine da 2 MB o da 4 KB.
+ */
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    char* base;
+    size_t size;
+    size_t used;
+} ArenaChunk;
+
+typedef struct {
+    ArenaChunk* chunks;      // Chunk corrente in testa
+    size_t chunk_size;       // Dimensione minima di un nuovo chunk
+    ArenaPages pages;
+    size_t allocated;        // Byte consegnati dall'ultimo reset
+    size_t peak;             // Massimo di allocated tra un reset e l'altro
+    int fresh_pages;         // arena_reset restituisce le pagine al kernel (MADV_DONTNEED)
+} Arena;
+
+Arena* arena_create(size_t chunk_size, ArenaPages pages);
+void* arena_alloc(Arena* arena, size_t bytes);
+void arena_reset(Arena* arena);
+// Pagine nuove dopo ogni reset: il chunk resta mappato ma le sue pagine
+// vengono rilasciate, così il first-touch NUMA della matrice successiva
+// decide di nuovo il nodo invece di ereditare quello della precedente
+void arena_set_fresh_pages(Arena* arena, int enable);
+void arena_destroy(Arena* arena);
+
+/**
+ * Allocatore dei buffer persistenti (loader, convertitori, vettori).
+ *
+ * Se è impostata un'arena corrente, spmv_malloc alloca da essa e
+ * spmv_free sui suoi puntatori non fa nulla; altrimenti si usa
+ * posix_memalign / free. spmv_free va chiamata prima di arena_reset.
+ */
+void spmv_set_arena(Arena* arena);
+Arena* spmv_get_arena(void);
+void* spmv_malloc(size_t bytes);
+void* spmv_calloc(size_t count, size_t size);
+// Sempre posix_memalign, anche con un'arena corrente: per le copie che
+// sostituiscono buffer già in arena, che altrimenti la farebbero crescere
+// fino al reset; spmv_free le rilascia davvero
+void* spmv_malloc_heap(size_t bytes);
+void spmv_free(void* ptr);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include "CSR_Matrix.h"
+
+#define AUTOTUNE_REPETITIONS 10
+
+
+// Costruisce HLL per ogni candidato, cronometra il piano SpMV e restituisce il miglior HackSize
+int autotune_hacksize(const CSRMatrix* csr, int nthreads, double* best_time);
+
+// File di tuning: una riga "<matrice> <hacksize> <tempo>" per matrice
+int load_tuned_hacksize(const char* tune_path, const char* matrix_name);
+int store_tuned_hacksize(const char* tune_path, const char* matrix_name, int hack_size, double time);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef CACHE_INFO_H
+#define CACHE_INFO_H
+
+#include <stddef.h>
+
+// Usata se né sysfs né sysconf riportano la cache di ultimo livello
+#define LLC_DEFAULT_BYTES (8UL << 20)
+
+// Dimensione in byte della cache dati/unificata di livello più alto vista
+// dalla CPU 0, letta da /sys/devices/system/cpu/cpu0/cache/index*/
+size_t detect_llc_size(void);
+
+#endif
@@ -1,7 +1,105 @@
-#ifdef CALCULUS_H
+#ifndef CALCULUS_H
 #define CALCULUS_H
 
+#include "CSR_Matrix.h"
+#include "HLL_Matrix.h"
+#include "partition.h"
+#include "MP_Matrix.h"
+#include "SYM_Matrix.h"
+#include "BCSR_Matrix.h"
+#include "DIA_Matrix.h"
+#include "HYB_Matrix.h"
+#include "TILED_Matrix.h"
+
 void csr_serial_mat_per_vec(CSRMatrix *csr_matrix, double *x, double *y);
 void hll_serial_mat_per_vec(HLLMatrix *hll_matrix, const double *x, double *y);
 void print_vector(double *y, int size);
+void csr_parallel_mat_per_vec(CSRMatrix *csr_matrix, double *x, double *y);
+void hll_parallel_mat_per_vec_improved(HLLMatrix *hll_matrix, const double *x, double *y);
+
+// CSR parallelo bilanciato sui non-zero con partizione merge-path precalcolata
+void csr_merge_path_mat_per_vec(CSRMatrix *csr_matrix, CSRPartition *part, const double *x, double *y);
+
+// Livello SIMD dei kernel vettoriali, scelto a runtime via CPUID
+typedef enum {
+    SIMD_SCALAR = 0,
+    SIMD_AVX2,
+    SIMD_AVX512
+} SimdLevel;
+
+// Miglior livello supportato dalla CPU (limitabile con SPMV_SIMD=scalar|avx2|avx512)
+SimdLevel detect_simd_level(void);
+const char* simd_level_name(SimdLevel level);
+
+// Kernel su un intervallo di righe (CSR) o di blocchi (HLL) per un livello SIMD fissato
+typedef void (*CSRRowsKernel)(const CSRMatrix *csr_matrix, int row_begin, int row_end,
+                              const double *x, double *y);
+typedef void (*HLLBlocksKernel)(const HLLMatrix *hll_matrix, int first_block, int last_block,
+                                const double *x, double *y);
+CSRRowsKernel csr_simd_rows_kernel(SimdLevel level);
+HLLBlocksKernel hll_simd_blocks_kernel(SimdLevel level);
+
+// Kernel HLL vettoriali: gather di x[JA] e FMA sulle righe consecutive di un hack
+void hll_simd_mat_per_vec_blocks(const HLLMatrix *hll_matrix, int first_block, int last_block,
+                                 const double *x, double *y);
+void hll_serial_simd_mat_per_vec(HLLMatrix *hll_matrix, const double *x, double *y);
+void hll_parallel_simd_mat_per_vec(HLLMatrix *hll_matrix, const double *x, double *y);
+
+// Kernel CSR vettoriali: 4 accumulatori indipendenti, gather e coda mascherata
+void csr_simd_mat_per_vec_rows(const CSRMatrix *csr_matrix, int row_begin, int row_end,
+                               const double *x, double *y);
+void csr_serial_simd_mat_per_vec(CSRMatrix *csr_matrix, const double *x, double *y);
+void csr_parallel_simd_mat_per_vec(CSRMatrix *csr_matrix, const double *x, double *y);
+
+// SpMM: Y (M x k) = A * X (N x k), blocchi densi row-major; kernel specializzati per k = 1..16
+void csr_serial_mat_per_mat(CSRMatrix *csr_matrix, const double *X, int k, double *Y);
+void csr_parallel_mat_per_mat(CSRMatrix *csr_matrix, const double *X, int k, double *Y);
+void hll_serial_mat_per_mat(HLLMatrix *hll_matrix, const double *X, int k, double *Y);
+void hll_parallel_mat_per_mat(HLLMatrix *hll_matrix, const double *X, int k, double *Y);
+
+// Precisione mista: valori float e indici compressi, accumulo in double
+void csr_mp_serial_mat_per_vec(CSRMatrixMP *mat, const double *x, double *y);
+void csr_mp_parallel_mat_per_vec(CSRMatrixMP *mat, const double *x, double *y);
+void hll_mp_serial_mat_per_vec(HLLMatrixMP *mat, const double *x, double *y);
+void hll_mp_parallel_mat_per_vec(HLLMatrixMP *mat, const double *x, double *y);
+
+// HLL con stream di indici compatto (blocchi base + stride rigenerati al volo)
+void hll_compact_serial_mat_per_vec(HLLMatrix *hll_matrix, HLLCompactIndex *index, const double *x, double *y);
+void hll_compact_parallel_mat_per_vec(HLLMatrix *hll_matrix, HLLCompactIndex *index, const double *x, double *y);
+
+// Simmetrica a triangolo inferiore: parallelo con buffer y parziali per thread
+void csr_sym_serial_mat_per_vec(const CSRSymMatrix *sym, const double *x, double *y);
+void csr_sym_parallel_mat_per_vec(CSRSymMatrix *sym, const double *x, double *y);
+
+// BCSR con kernel specializzati per blocchi 2x2, 3x3, 4x4, 6x6
+void bcsr_serial_mat_per_vec(BCSRMatrix *bcsr_matrix, const double *x, double *y);
+void bcsr_parallel_mat_per_vec(BCSRMatrix *bcsr_matrix, const double *x, double *y);
+
+// DIA (bande/stencil) e HYB (ELL + coda COO)
+void dia_serial_mat_per_vec(DIAMatrix *dia_matrix, const double *x, double *y);
+void dia_parallel_mat_per_vec(DIAMatrix *dia_matrix, const double *x, double *y);
+void hyb_serial_mat_per_vec(HYBMatrix *hyb_matrix, const double *x, double *y);
+void hyb_parallel_mat_per_vec(HYBMatrix *hyb_matrix, const double *x, double *y);
+
+// CSR a pannelli di colonne dimensionati sulla LLC
+void csr_tiled_serial_mat_per_vec(CSRTiledMatrix *tiled_matrix, const double *x, double *y);
+void csr_tiled_parallel_mat_per_vec(CSRTiledMatrix *tiled_matrix, const double *x, double *y);
+
+// Prodotto scalare opzionale calcolato nella stessa passata della SpMV fusa
+typedef enum {
+    SPMV_DOT_NONE = 0,
+    SPMV_DOT_XAX,            // <x, A x>, solo matrici quadrate
+    SPMV_DOT_YY              // <y, y> sul risultato
+} SpmvDot;
+
+// y = alpha * A * x + beta * y (beta == 0: y non letto); restituisce il prodotto scalare richiesto
+double csr_fused_serial_mat_per_vec(CSRMatrix *csr_matrix, double alpha, const double *x,
+                                    double beta, double *y, SpmvDot dot);
+double csr_fused_parallel_mat_per_vec(CSRMatrix *csr_matrix, double alpha, const double *x,
+                                      double beta, double *y, SpmvDot dot);
+double hll_fused_serial_mat_per_vec(HLLMatrix *hll_matrix, double alpha, const double *x,
+                                    double beta, double *y, SpmvDot dot);
+double hll_fused_parallel_mat_per_vec(HLLMatrix *hll_matrix, double alpha, const double *x,
+                                      double beta, double *y, SpmvDot dot);
 
+#endif
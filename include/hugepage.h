@@ -0,0 +1,18 @@
+#ifndef HUGEPAGE_H
+#define HUGEPAGE_H
+
+#include <stddef.h>
+
+// Pagine effettivamente ottenute per le VMA che coprono [ptr, ptr + bytes):
+// dimensione di pagina del kernel e frazione residente in pagine da 2 MB
+// (THP o hugetlbfs), letti da /proc/self/smaps
+typedef struct {
+    size_t kernel_page_kb;   // KernelPageSize massimo tra le VMA (2048 con hugetlbfs)
+    size_t rss_kb;           // Memoria residente delle VMA
+    size_t huge_kb;          // AnonHugePages + Private/Shared_Hugetlb
+} PageUsage;
+
+int query_page_usage(const void* ptr, size_t bytes, PageUsage* usage);
+void hugepage_report(const char* label, const void* ptr, size_t bytes);
+
+#endif
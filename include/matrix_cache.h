@@ -0,0 +1,54 @@
+#ifndef MATRIX_CACHE_H
+#define MATRIX_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CSR_Matrix.h"
+#include "HLL_Matrix.h"
+
+#define MATRIX_CACHE_MAGIC "SPMVBIN"
+#define MATRIX_CACHE_VERSION 5
+
+// Header del file binario; tutte le sezioni sono allineate a 64 byte
+typedef struct {
+    char magic[8];               // MATRIX_CACHE_MAGIC
+    uint32_t version;            // MATRIX_CACHE_VERSION
+    uint32_t header_size;        // sizeof(MatrixCacheHeader)
+    uint64_t file_size;          // Dimensione totale del file di cache
+    uint64_t source_size;        // Dimensione del .mtx sorgente
+    int64_t source_mtime_sec;    // mtime del .mtx sorgente (secondi)
+    int64_t source_mtime_nsec;   // mtime del .mtx sorgente (nanosecondi)
+    int32_t M;                   // Righe
+    int32_t N;                   // Colonne
+    int32_t NZ;                  // Non-zero count
+    int32_t hack_size;           // HackSize usato per la parte HLL
+    int32_t num_blocks;          // Numero di blocchi HLL
+    int32_t reserved;
+    uint64_t irp_offset;         // CSR: IRP (M + 1 int)
+    uint64_t ja_offset;          // CSR: JA (NZ int)
+    uint64_t as_offset;          // CSR: AS (NZ double)
+    uint64_t hack_offset_offset; // HLL: hack_offset (num_blocks + 1 int64)
+    uint64_t hll_ja_offset;      // HLL: buffer JA contiguo
+    uint64_t hll_as_offset;      // HLL: buffer AS contiguo
+    uint64_t perm_offset;        // HLL: permutazione SELL-C-sigma (M int), 0 se assente
+} MatrixCacheHeader;
+
+// Matrici ricaricate da cache: gli array puntano direttamente nel file mappato
+typedef struct {
+    CSRMatrix csr;
+    HLLMatrix hll;
+    void* map;
+    size_t map_size;
+} MatrixCache;
+
+// Apre la cache se esiste, è valida e non è più vecchia del sorgente (NULL altrimenti)
+MatrixCache* matrix_cache_open(const char* cache_path, const char* source_path, int hack_size);
+
+// Scrive la cache per il sorgente indicato; restituisce 0 in caso di successo
+int matrix_cache_store(const char* cache_path, const char* source_path,
+                       const CSRMatrix* csr, const HLLMatrix* hll);
+
+// Rilascia la mappatura e le strutture associate
+void matrix_cache_close(MatrixCache* cache);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef MATRIX_FEATURES_H
+#define MATRIX_FEATURES_H
+
+#include "CSR_Matrix.h"
+#include "spmv_plan.h"
+
+// Statistiche strutturali di una matrice CSR usate per scegliere il formato
+typedef struct {
+    int M;                       // Righe
+    int N;                       // Colonne
+    int NZ;                      // Non-zero
+    int symmetric;               // Banner Matrix Market symmetric (fornito dal chiamante)
+    double row_mean;             // Media dei non-zero per riga
+    double row_variance;         // Varianza dei non-zero per riga
+    int row_max;                 // Riga più lunga
+    int empty_rows;              // Righe senza elementi
+    int bandwidth;               // max |i - j| sugli elementi memorizzati
+    double diag_dominance;       // Frazione di righe con |a_ii| >= sum_{j != i} |a_ij|
+    double hll_padding_ratio;    // Slot HLL memorizzati / NZ (>= 1) con hack_size
+    int hack_size;               // HackSize usato per hll_padding_ratio
+    double sell_padding_ratio;   // Come sopra, con righe ordinate in finestre di sell_sigma righe
+    int sell_sigma;              // Finestra di ordinamento SELL-C-sigma valutata
+    int dia_diagonals;           // Diagonali occupate
+    double dia_fill_ratio;       // dia_diagonals * M / NZ
+    int bcsr_r;                  // Blocco BCSR con il minor traffico stimato (1x1: nessuno)
+    int bcsr_c;
+    double bcsr_fill_ratio;      // Valori memorizzati / NZ con il blocco bcsr_r x bcsr_c
+    int hyb_ell_width;           // Larghezza ELL di hyb_select_ell_width
+    double hyb_ell_fill;         // Slot ELL (ell_width * M) / non-zero che vi finiscono
+    double hyb_coo_fraction;     // Frazione dei non-zero nella coda COO
+    int panel_width;             // Colonne per pannello della CSR a pannelli
+    int num_panels;              // Pannelli necessari a coprire N colonne
+} MatrixFeatures;
+
+// Formato scelto dall'analizzatore, con la variante di kernel che il piano
+// userà e i parametri per costruire la matrice
+typedef struct {
+    SpmvFormat format;
+    SpmvKernel kernel;
+    int hack_size;               // HLL: righe per blocco
+    int sigma;                   // HLL: > 0 usare SELL-C-sigma con questa finestra
+    int block_r;                 // BCSR: righe per blocco
+    int block_c;                 // BCSR: colonne per blocco
+    int ell_width;               // HYB: elementi per riga nella parte ELL
+    int panel_width;             // TILED: colonne per pannello
+    double max_fill;             // DIA: riempimento massimo ammesso nella conversione
+    int jacobi;                  // Solutori: diagonale abbastanza dominante per PCG Jacobi
+    const char* reason;          // Motivazione leggibile della scelta
+} FormatChoice;
+
+// symmetric: il file dichiara la matrice simmetrica; panel_width <= 0: dalla LLC
+void compute_matrix_features(const CSRMatrix* csr, int hack_size, int symmetric, int panel_width,
+                             MatrixFeatures* features);
+FormatChoice select_spmv_format(const MatrixFeatures* features);
+// Costruisce la matrice del formato scelto da csr (hll è già HackSize choice->hack_size)
+// e un piano che ne è proprietario; se la conversione rifiuta la matrice ripiega sulla CSR
+spmv_plan_t* spmv_plan_create_for_choice(CSRMatrix* csr, HLLMatrix* hll, FormatChoice* choice);
+void print_matrix_features(const MatrixFeatures* features);
+void print_format_choice(const FormatChoice* choice);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef NUMA_ALLOC_H
+#define NUMA_ALLOC_H
+
+#include <stddef.h>
+#include "CSR_Matrix.h"
+#include "HLL_Matrix.h"
+
+/**
+ * Allocazione NUMA-aware per first-touch.
+ *
+ * Linux assegna una pagina al nodo del thread che la scrive per primo: le
+ * funzioni seguenti ricopiano i dati in buffer nuovi facendo scrivere a
+ * ogni thread esattamente la porzione che leggerà nel kernel (stessa
+ * partizione row_start / block_start), con i thread fissati alle CPU.
+ * Le copie delle matrici arrivano da spmv_malloc_heap, fuori dall'arena
+ * (i buffer sostituiti restano in arena fino al reset); i vettori da
+ * spmv_malloc: se è impostata un'arena, deve avere arena_set_fresh_pages
+ * attivo, altrimenti dopo un arena_reset le pagine riusate hanno già un
+ * nodo e il first-touch non le sposta.
+ */
+
+// Fissa ogni thread OpenMP a una CPU dell'affinità del processo; restituisce i thread fissati
+int numa_pin_threads(void);
+
+// Vettore azzerato, pagine toccate per intervalli di righe row_start[t]..row_start[t+1]
+double* numa_alloc_vector(int size, const int* row_start, int nthreads);
+
+// Ricopia IRP/JA/AS (CSR) o JA/AS (HLL) con first-touch per partizione; la
+// matrice deve possedere i propri buffer (non una vista su cache mmap)
+void numa_place_csr(CSRMatrix* csr, const int* row_start, int nthreads);
+void numa_place_hll(HLLMatrix* hll, const int* block_start, int nthreads);
+
+// Stampa la distribuzione per nodo delle pagine di [ptr, ptr + bytes) (move_pages)
+void numa_report_placement(const char* label, const void* ptr, size_t bytes);
+
+#endif
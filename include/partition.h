@@ -0,0 +1,20 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "CSR_Matrix.h"
+
+// Partizione merge-path di una matrice CSR: lo spazio righe + non-zero
+// (M + NZ passi) è diviso in parti uguali, una per thread
+typedef struct {
+    int nthreads;            // Numero di partizioni
+    int* row_start;          // Riga iniziale della partizione t (nthreads + 1 elementi)
+    int* nz_start;           // Primo non-zero della partizione t (nthreads + 1 elementi)
+    int* carry_row;          // Riga lasciata a metà dalla partizione t (carry-out)
+    double* carry_val;       // Somma parziale della riga carry_row[t]
+} CSRPartition;
+
+// Calcola la partizione una volta per matrice; riutilizzabile tra chiamate
+CSRPartition* csr_merge_path_partition(const CSRMatrix* csr, int nthreads);
+void free_csr_partition(CSRPartition* part);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "CSR_Matrix.h"
+
+// Permutazione simmetrica di una matrice quadrata: perm[nuovo] = vecchio,
+// stessa convenzione di HLLMatrix.perm
+typedef struct {
+    int n;
+    int* perm;               // perm[i] = riga/colonna originale in posizione i
+    int* iperm;              // iperm[perm[i]] = i
+} Reordering;
+
+// Reverse Cuthill-McKee sul grafo di A + A^T; NULL se la matrice non è quadrata
+Reordering* rcm_reordering(const CSRMatrix* csr);
+void free_reordering(Reordering* r);
+
+// B = P A P^T, con colonne ordinate all'interno di ogni riga
+CSRMatrix* permute_csr_symmetric(const CSRMatrix* csr, const Reordering* r);
+
+// out[i] = v[perm[i]] (vettore originale -> ordine permutato) e inversa
+void permute_vector(const Reordering* r, const double* v, double* out);
+void unpermute_vector(const Reordering* r, const double* v, double* out);
+
+// max |i - j| e profilo (somma su i di i - min_j a_ij, per min_j < i)
+int csr_bandwidth(const CSRMatrix* csr);
+long long csr_profile(const CSRMatrix* csr);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "spmv_plan.h"
+
+/**
+ * Solutori iterativi sul piano SpMV scelto dal driver, in qualunque formato.
+ *
+ * Il workspace alloca una volta i vettori di lavoro e la diagonale
+ * inversa per Jacobi; le iterazioni non allocano. Ogni iterazione fa una
+ * SpMV fusa con il prodotto scalare che le serve e al più due passate
+ * fuse sui vettori. La SpMV è quella del piano (kernel SIMD e partizione
+ * per thread, quindi anche il piazzamento NUMA): ogni thread calcola il
+ * prodotto scalare sulle righe che ha appena scritto (per SYM, DIA, HYB,
+ * BCSR e a pannelli in una passata separata dopo il kernel del formato).
+ */
+typedef struct {
+    spmv_plan_t* plan;
+    int n;
+    double* r;               // Residuo
+    double* z;               // Residuo precondizionato (PCG)
+    double* p;               // Direzione di ricerca
+    double* q;               // A p
+    double* inv_diag;        // 1 / a_ii, calcolata al primo PCG
+    size_t spmv_bytes;       // Traffico minimo di una SpMV: matrice + x + y
+} SolverWorkspace;
+
+typedef struct {
+    int iterations;
+    int converged;
+    double residual;         // ||r|| / ||b|| finale (CG); variazione relativa di lambda (potenze)
+    double eigenvalue;       // Solo metodo delle potenze
+    double seconds;
+    double iter_per_sec;
+    double gbytes_per_sec;   // Traffico stimato (SpMV + passate sui vettori) / tempo
+    const char* kernel;      // Kernel SpMV effettivamente usato nelle iterazioni
+} SolverStats;
+
+// NULL se la matrice del piano non è quadrata
+SolverWorkspace* solver_workspace_create(spmv_plan_t* plan);
+void solver_workspace_destroy(SolverWorkspace* ws);
+
+// A x = b, A simmetrica definita positiva; x contiene la stima iniziale
+int solver_cg(SolverWorkspace* ws, const double* b, double* x, double tol, int max_iter, SolverStats* stats);
+// Come solver_cg con precondizionatore di Jacobi (diagonale, 1 se a_ii == 0)
+int solver_pcg_jacobi(SolverWorkspace* ws, const double* b, double* x, double tol, int max_iter, SolverStats* stats);
+// Autovalore dominante (quoziente di Rayleigh); x: vettore iniziale non nullo, alla fine l'autovettore normalizzato
+int solver_power_iteration(SolverWorkspace* ws, double* x, double tol, int max_iter, SolverStats* stats);
+
+void solver_print_stats(const char* name, const SolverStats* stats);
+
+#endif
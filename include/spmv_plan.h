@@ -0,0 +1,87 @@
+#ifndef SPMV_PLAN_H
+#define SPMV_PLAN_H
+
+#include "CSR_Matrix.h"
+#include "HLL_Matrix.h"
+#include "SYM_Matrix.h"
+#include "DIA_Matrix.h"
+#include "HYB_Matrix.h"
+#include "BCSR_Matrix.h"
+#include "TILED_Matrix.h"
+#include "partition.h"
+#include "calculus.h"
+
+// Formato della matrice a cui si riferisce il piano
+typedef enum {
+    SPMV_FORMAT_CSR = 0,
+    SPMV_FORMAT_HLL,
+    SPMV_FORMAT_SYM,
+    SPMV_FORMAT_DIA,
+    SPMV_FORMAT_HYB,
+    SPMV_FORMAT_BCSR,
+    SPMV_FORMAT_TILED
+} SpmvFormat;
+
+// Variante di kernel fissata alla creazione del piano
+typedef enum {
+    SPMV_KERNEL_CSR_ROWS = 0,    // Intervalli di righe intere bilanciati, kernel CSR SIMD
+    SPMV_KERNEL_CSR_MERGE_PATH,  // Merge-path con carry-out, per righe molto lunghe
+    SPMV_KERNEL_HLL_BLOCKS,      // Intervalli di blocchi bilanciati sul padding, kernel HLL SIMD
+    SPMV_KERNEL_SYM_PARTIAL,     // Triangolo inferiore, aggiornamenti trasposti in buffer per thread
+    SPMV_KERNEL_DIA_ROWS,        // Intervalli di righe uguali, diagonale per diagonale
+    SPMV_KERNEL_HYB_ELL_COO,     // Tile di righe ELL, poi porzioni uguali della coda COO
+    SPMV_KERNEL_BCSR_BLOCKS,     // Righe di blocchi, kernel specializzato per R x C
+    SPMV_KERNEL_TILED_PANELS     // Pannelli di colonne in sequenza, righe bilanciate per thread
+} SpmvKernel;
+
+/**
+ * Piano di esecuzione SpMV persistente.
+ *
+ * Alla creazione vengono fissati partizioni per thread, variante di kernel
+ * e livello SIMD (con i relativi puntatori a funzione); l'esecuzione non fa più analisi né allocazioni, quindi
+ * un solutore iterativo paga il costo di setup una sola volta.
+ */
+typedef struct spmv_plan {
+    SpmvFormat format;
+    SpmvKernel kernel;
+    SimdLevel simd;
+    int nthreads;
+    int M;
+    int N;
+    CSRMatrix* csr;          // Valido se format == SPMV_FORMAT_CSR
+    HLLMatrix* hll;          // Valido se format == SPMV_FORMAT_HLL
+    CSRSymMatrix* sym;       // Valido se format == SPMV_FORMAT_SYM
+    DIAMatrix* dia;          // Valido se format == SPMV_FORMAT_DIA
+    HYBMatrix* hyb;          // Valido se format == SPMV_FORMAT_HYB
+    BCSRMatrix* bcsr;        // Valido se format == SPMV_FORMAT_BCSR
+    CSRTiledMatrix* tiled;   // Valido se format == SPMV_FORMAT_TILED
+    int owns_matrix;         // Se vero, spmv_plan_destroy libera anche la matrice (non CSR)
+    CSRRowsKernel csr_rows;  // Kernel CSR_ROWS per il livello simd del piano
+    HLLBlocksKernel hll_blocks; // Kernel HLL_BLOCKS per il livello simd del piano
+    int* part_start;         // Blocco iniziale di ogni thread per HLL, riga per gli altri formati (nthreads + 1)
+    CSRPartition* merge;     // Partizione merge-path (solo SPMV_KERNEL_CSR_MERGE_PATH)
+} spmv_plan_t;
+
+// CSR: righe intere o merge-path, a seconda del peso della riga più lunga sulla quota di un thread
+SpmvKernel spmv_csr_kernel_for(int M, int NZ, int row_max, int nthreads);
+const char* spmv_kernel_name(SpmvKernel kernel);
+const char* spmv_format_name(SpmvFormat format);
+
+// SYM e TILED usano il numero di thread con cui sono state costruite
+spmv_plan_t* spmv_plan_create(void* matrix, SpmvFormat format, int nthreads);
+void spmv_plan_execute(spmv_plan_t* plan, const double* x, double* y);
+// Come spmv_plan_execute, più il prodotto scalare richiesto: ogni thread lo
+// calcola sulle righe appena scritte della propria partizione (merge-path e
+// formati con sincronizzazione interna: passata separata sulla stessa partizione)
+double spmv_plan_execute_dot(spmv_plan_t* plan, const double* x, double* y, SpmvDot dot);
+const char* spmv_plan_kernel_name(const spmv_plan_t* plan);
+void spmv_plan_destroy(spmv_plan_t* plan);
+void spmv_plan_print(const spmv_plan_t* plan);
+
+// Confini di riga della partizione per thread del piano (nthreads + 1 elementi)
+void spmv_plan_row_start(const spmv_plan_t* plan, int* row_start);
+// Ricolloca i buffer della matrice con first-touch secondo la partizione del piano
+// (solo CSR e HLL; gli altri formati restano dove li ha scritti la conversione)
+void spmv_plan_first_touch(spmv_plan_t* plan);
+
+#endif
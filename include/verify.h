@@ -6,4 +6,9 @@
 
 bool verify_csr_matrix(const CSRMatrix* mat, bool verbose);
 
+// Confronto tra vettori risultato: 1 se l'errore relativo in norma 2 è <= tol
+int compute_norm(const double *v1, const double *v2, int size, double tol);
+// Report dell'errore di y rispetto al riferimento in doppia precisione
+void report_accuracy(const char *label, const double *ref, const double *y, int size);
+
 #endif
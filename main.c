@@ -5,26 +5,63 @@
 #include <unistd.h>
 #include <dirent.h>
 #include <errno.h>
+#include <sys/stat.h>
 #include "include/mmio.h"
 #include "include/CSR_Matrix.h"
 #include "include/HLL_Matrix.h"
 #include "include/verify.h"
 #include "include/initialize.h"
-#include "include/utils.h"
 #include "include/calculus.h"
+#include "include/matrix_cache.h"
+#include "include/spmv_plan.h"
+#include "include/matrix_features.h"
+#include "include/autotune.h"
+#include "include/reorder.h"
+#include "include/numa_alloc.h"
+#include "include/arena.h"
+#include "include/hugepage.h"
+#include "include/cache_info.h"
+#include "include/solver.h"
 
 #define COMPUTATION_NUMBER 5
 #define MATRIX_DIR "../matrix/"
+#define MATRIX_CACHE_DIR "../matrix_cache/"
+#define TUNING_FILE MATRIX_CACHE_DIR "hacksize.tune"
+#define SOLVER_TOLERANCE 1e-8
+#define SOLVER_MAX_ITERATIONS 1000
 
 extern void csr_serial_mat_per_vec(CSRMatrix *csr_matrix, double *x, double *y);
 extern void hll_serial_mat_per_vec(HLLMatrix *hll_matrix, const double *x, double *y);
 extern void re_initialize_y_vector(int size, double *y);
 extern int compute_norm(const double *v1, const double *v2, int size, double tol);
 
-int main() {
+int main(int argc, char **argv) {
     DIR *dir;
     struct dirent *entry;
     char path[512];
+    char cache_path[512];
+
+    // --autotune: prova diversi HackSize per ogni matrice e salva il migliore
+    // --rcm: riordina righe e colonne con Reverse Cuthill-McKee prima della conversione
+    // --numa: thread fissati alle CPU e first-touch di matrice e vettori per partizione
+    // --hugepages: arena su pagine da 2 MB, confrontata con una copia a pagine da 4 KB
+    // --panel-width=W: colonne per pannello della CSR a pannelli (default: dalla LLC)
+    // --solve: CG, PCG Jacobi e metodo delle potenze sul piano scelto (matrici quadrate)
+    int autotune = 0, reorder = 0, numa = 0, hugepages = 0, panel_width = 0, solve = 0;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--autotune") == 0) autotune = 1;
+        else if (strcmp(argv[a], "--rcm") == 0) reorder = 1;
+        else if (strcmp(argv[a], "--numa") == 0) numa = 1;
+        else if (strcmp(argv[a], "--hugepages") == 0) hugepages = 1;
+        else if (strcmp(argv[a], "--solve") == 0) solve = 1;
+        else if (strncmp(argv[a], "--panel-width=", 14) == 0) panel_width = atoi(argv[a] + 14);
+    }
+
+    size_t llc_bytes = detect_llc_size();
+    if (panel_width <= 0) panel_width = tiled_panel_width(llc_bytes);
+    printf("LLC: %zu KB, pannello CSR: %d colonne\n", llc_bytes >> 10, panel_width);
+
+    if (numa) printf("Thread fissati alle CPU: %d\n", numa_pin_threads());
 
     dir = opendir(MATRIX_DIR);
     if (!dir) {
@@ -32,6 +69,18 @@ int main() {
         return EXIT_FAILURE;
     }
 
+    // La cache binaria vive fuori da MATRIX_DIR, che viene scandita per intero
+    if (mkdir(MATRIX_CACHE_DIR, 0755) != 0 && errno != EEXIST) {
+        perror("Errore creazione directory cache");
+    }
+
+    // Buffer di matrici e vettori dall'arena, rilasciata in blocco a fine matrice
+    Arena* arena = arena_create(ARENA_DEFAULT_CHUNK, hugepages ? ARENA_PAGES_HUGE : ARENA_PAGES_DEFAULT);
+    // Con --numa ogni matrice deve ripartire da pagine mai toccate, altrimenti
+    // il first-touch per partizione non ha effetto dalla seconda in poi
+    arena_set_fresh_pages(arena, numa);
+    spmv_set_arena(arena);
+
     while ((entry = readdir(dir)) != NULL) {
 
         if (entry->d_name[0] == '.') continue; // salta . e ..
@@ -39,36 +88,127 @@ int main() {
         snprintf(path, sizeof(path), "%s%s", MATRIX_DIR, entry->d_name);
         printf("\nProcessing matrix: %s\n", entry->d_name);
 
-        // Caricamento matrice CSR
-        CSRMatrix* csr = load_matrix_market_to_csr(path);
-        if (!csr) {
-            printf("Errore nella lettura CSR per %s\n", entry->d_name);
-            continue;
+        snprintf(cache_path, sizeof(cache_path), "%s%s.bin", MATRIX_CACHE_DIR, entry->d_name);
+        int hacksize = load_tuned_hacksize(TUNING_FILE, entry->d_name);
+        if (hacksize <= 0) hacksize = HLL_DEFAULT_HACKSIZE;
+
+        // Ricarica zero-copy dalla cache se aggiornata, altrimenti parsing del .mtx
+        CSRMatrix* csr;
+        HLLMatrix* hll;
+        // La cache contiene la matrice nell'ordine originale: niente cache con --rcm;
+        // con --numa e --hugepages la matrice deve stare in memoria anonima, non nella page cache
+        CSRMatrix* original = NULL;
+        Reordering* rcm = NULL;
+        MatrixCache* cache = (autotune || reorder || numa || hugepages) ? NULL : matrix_cache_open(cache_path, path, hacksize);
+        if (cache) {
+            csr = &cache->csr;
+            hll = &cache->hll;
+        } else {
+            // Caricamento matrice CSR
+            csr = load_matrix_market_to_csr(path);
+            if (!csr) {
+                printf("Errore nella lettura CSR per %s\n", entry->d_name);
+                continue;
+            }
+
+            if (reorder && (rcm = rcm_reordering(csr)) != NULL) {
+                original = csr;
+                csr = permute_csr_symmetric(original, rcm);
+                printf("RCM: bandwidth %d -> %d, profilo %lld -> %lld\n",
+                       csr_bandwidth(original), csr_bandwidth(csr), csr_profile(original), csr_profile(csr));
+            }
+
+            if (autotune) {
+                double best_time;
+                printf("Autotuning HackSize per %s\n", entry->d_name);
+                hacksize = autotune_hacksize(csr, 0, &best_time);
+                printf("HackSize migliore: %d (%.6lf s)\n", hacksize, best_time);
+                store_tuned_hacksize(TUNING_FILE, entry->d_name, hacksize, best_time);
+            }
+
+            // Conversione a HLL
+            hll = convert_csr_to_hll(csr, hacksize);
+
+            if (!reorder && matrix_cache_store(cache_path, path, csr, hll) != 0) {
+                printf("Impossibile salvare la cache per %s\n", entry->d_name);
+            }
         }
 
-        // Conversione a HLL
-        int hacksize = 32;
-        HLLMatrix* hll = convert_csr_to_hll(csr, hacksize);
+        // Simmetria dal solo banner: vale anche per la cache e dopo RCM (P A P^T resta simmetrica)
+        int symmetric = matrix_market_is_symmetric(path);
 
         // Inizializzazione vettori
         double *x = initialize_x_vector(csr->N);
         double *y = initialize_y_vector(csr->M);
         double *z = initialize_y_vector(csr->M);
 
-        double start, end, time_csr = 0.0, time_hll = 0.0;
+        // Con RCM x viene portato nell'ordine permutato; il riferimento sulla
+        // matrice originale serve a verificare il risultato riportato indietro
+        double *y_ref = NULL;
+        if (rcm) {
+            y_ref = initialize_y_vector(csr->M);
+            csr_serial_mat_per_vec(original, x, y_ref);
+            permute_vector(rcm, x, z);
+            memcpy(x, z, csr->N * sizeof(double));
+            free_csr_matrix(original);
+        }
+
+        // Analisi della struttura e scelta automatica del formato, con kernel e parametri
+        MatrixFeatures features;
+        compute_matrix_features(csr, hacksize, symmetric, panel_width, &features);
+        print_matrix_features(&features);
+        FormatChoice choice = select_spmv_format(&features);
+
+        // Il piano possiede la matrice del formato scelto (SELL-C-sigma, SYM, DIA, ...)
+        spmv_plan_t* plan = spmv_plan_create_for_choice(csr, hll, &choice);
+        print_format_choice(&choice);
+        if (plan->hll && plan->hll->perm) {
+            printf("Padding HLL: %.3f -> SELL-C-sigma: %.3f\n", hll_padding_ratio(hll), hll_padding_ratio(plan->hll));
+        }
+        spmv_plan_print(plan);
+
+        // First-touch con la partizione del piano: ogni thread scrive le
+        // pagine di matrice e y che leggerà nel kernel
+        if (numa) {
+            int row_start[plan->nthreads + 1];
+            spmv_plan_row_start(plan, row_start);
+            spmv_plan_first_touch(plan);
+            spmv_free(y);
+            spmv_free(z);
+            y = numa_alloc_vector(csr->M, row_start, plan->nthreads);
+            z = numa_alloc_vector(csr->M, row_start, plan->nthreads);
+
+            if (plan->format == SPMV_FORMAT_CSR) {
+                numa_report_placement("CSR JA", csr->JA, (size_t)csr->NZ * sizeof(int));
+                numa_report_placement("CSR AS", csr->AS, (size_t)csr->NZ * sizeof(double));
+            } else if (plan->format == SPMV_FORMAT_HLL) {
+                size_t slots = (size_t)plan->hll->hack_offset[plan->hll->num_blocks];
+                numa_report_placement("HLL JA", plan->hll->JA, slots * sizeof(int));
+                numa_report_placement("HLL AS", plan->hll->AS, slots * sizeof(double));
+            }
+            numa_report_placement("y", z, (size_t)csr->M * sizeof(double));
+        }
+
+        double start, end, time_csr = 0.0, time_hll = 0.0, time_auto = 0.0;
 
         // Esecuzione CSR seriale
         for (int i = 0; i < COMPUTATION_NUMBER; i++) {
-            memset(y, 0, csr->M * sizeof(double));
             start = omp_get_wtime();
             csr_serial_mat_per_vec(csr, x, y);
             end = omp_get_wtime();
             time_csr += end - start;
         }
 
+        if (rcm) {
+            unpermute_vector(rcm, y, z);
+            if (!compute_norm(y_ref, z, csr->M, 1e-4)) {
+                printf("\u274c Differenza nei risultati CSR originale vs CSR riordinato per %s\n", entry->d_name);
+            }
+            spmv_free(y_ref);
+        }
+
         // Esecuzione HLL seriale + verifica
         for (int i = 0; i < COMPUTATION_NUMBER; i++) {
-            memset(z, 0, csr->M * sizeof(double));
             start = omp_get_wtime();
             hll_serial_mat_per_vec(hll, x, z);
             end = omp_get_wtime();
@@ -79,16 +219,280 @@ int main() {
             }
         }
 
+        // Esecuzione con il piano scelto automaticamente + verifica
+        for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+            start = omp_get_wtime();
+            spmv_plan_execute(plan, x, z);
+            end = omp_get_wtime();
+            time_auto += end - start;
+
+            if (!compute_norm(y, z, csr->M, 1e-4)) {
+                printf("\u274c Differenza nei risultati CSR vs piano automatico per %s\n", entry->d_name);
+            }
+        }
+
         printf("\u2705 Tempo medio CSR seriale per %s: %.6lf s\n", entry->d_name, time_csr / COMPUTATION_NUMBER);
         printf("\u2705 Tempo medio HLL seriale per %s: %.6lf s\n", entry->d_name, time_hll / COMPUTATION_NUMBER);
+        printf("\u2705 Tempo medio piano automatico per %s: %.6lf s\n", entry->d_name, time_auto / COMPUTATION_NUMBER);
+
+        // Passo tipico di un solutore: y = A x, y = 2 y - z, <y, y>; separato contro fuso.
+        // Entrambe le varianti ripartono da z = A x, quindi il risultato atteso è y
+        double time_split = 0.0, time_fused = 0.0, dot_split = 0.0, dot_fused = 0.0;
+        double* w = spmv_malloc(csr->M * sizeof(double));
+        for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+            memcpy(z, y, csr->M * sizeof(double));
+            start = omp_get_wtime();
+            csr_parallel_mat_per_vec(csr, x, w);
+            dot_split = 0.0;
+            #pragma omp parallel for schedule(static) reduction(+:dot_split)
+            for (int r = 0; r < csr->M; r++) {
+                w[r] = 2.0 * w[r] - z[r];
+                dot_split += w[r] * w[r];
+            }
+            end = omp_get_wtime();
+            time_split += end - start;
+
+            start = omp_get_wtime();
+            dot_fused = csr_fused_parallel_mat_per_vec(csr, 2.0, x, -1.0, z, SPMV_DOT_YY);
+            end = omp_get_wtime();
+            time_fused += end - start;
+        }
+        if (!compute_norm(y, z, csr->M, 1e-4) || !compute_norm(w, z, csr->M, 1e-4)) {
+            printf("\u274c Differenza nei risultati CSR vs CSR fusa per %s\n", entry->d_name);
+        }
+        printf("\u2705 Tempo medio SpMV + AXPBY + <y,y> per %s: separato %.6lf s, fuso CSR %.6lf s (<y,y> %.6e / %.6e)\n",
+               entry->d_name, time_split / COMPUTATION_NUMBER, time_fused / COMPUTATION_NUMBER, dot_split, dot_fused);
+
+        memcpy(z, y, csr->M * sizeof(double));
+        hll_fused_parallel_mat_per_vec(hll, 2.0, x, -1.0, z, SPMV_DOT_NONE);
+        if (!compute_norm(y, z, csr->M, 1e-4)) {
+            printf("\u274c Differenza nei risultati CSR vs HLL fusa per %s\n", entry->d_name);
+        }
+        spmv_free(w);
+
+        // Stesso kernel CSR su pagine da 2 MB e su una copia a pagine da 4 KB
+        if (hugepages) {
+            hugepage_report("CSR AS", csr->AS, (size_t)csr->NZ * sizeof(double));
+            hugepage_report("CSR JA", csr->JA, (size_t)csr->NZ * sizeof(int));
+            hugepage_report("x", x, (size_t)csr->N * sizeof(double));
+
+            Arena* small_pages = arena_create(ARENA_DEFAULT_CHUNK, ARENA_PAGES_SMALL);
+            spmv_set_arena(small_pages);
+            CSRMatrix* csr_small = copy_csr_matrix(csr);
+            double* x_small = spmv_malloc(csr->N * sizeof(double));
+            memcpy(x_small, x, csr->N * sizeof(double));
+            spmv_set_arena(arena);
+            hugepage_report("CSR AS baseline", csr_small->AS, (size_t)csr->NZ * sizeof(double));
+
+            spmv_plan_t* plan_huge = spmv_plan_create(csr, SPMV_FORMAT_CSR, 0);
+            spmv_plan_t* plan_small = spmv_plan_create(csr_small, SPMV_FORMAT_CSR, 0);
+            double time_huge = 0.0, time_small = 0.0;
+            for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+                start = omp_get_wtime();
+                spmv_plan_execute(plan_huge, x, z);
+                end = omp_get_wtime();
+                time_huge += end - start;
+
+                start = omp_get_wtime();
+                spmv_plan_execute(plan_small, x_small, z);
+                end = omp_get_wtime();
+                time_small += end - start;
+            }
+            printf("\u2705 Tempo medio CSR per %s: pagine 2 MB %.6lf s, pagine 4 KB %.6lf s (speedup %.2fx)\n",
+                   entry->d_name, time_huge / COMPUTATION_NUMBER, time_small / COMPUTATION_NUMBER,
+                   time_huge > 0.0 ? time_small / time_huge : 0.0);
+
+            spmv_plan_destroy(plan_huge);
+            spmv_plan_destroy(plan_small);
+            arena_destroy(small_pages);
+        }
+
+        // Precisione mista: valori float e indici delta a 16 bit, confronto con il CSR double
+        CSRMatrixMP* csr_mp = convert_csr_to_mp(csr, MP_INDEX_DELTA16);
+        HLLMatrixMP* hll_mp = convert_hll_to_mp(hll);
+        double time_csr_mp = 0.0, time_hll_mp = 0.0;
+
+        for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+            start = omp_get_wtime();
+            csr_mp_parallel_mat_per_vec(csr_mp, x, z);
+            end = omp_get_wtime();
+            time_csr_mp += end - start;
+        }
+        report_accuracy("CSR float/delta16", y, z, csr->M);
+
+        for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+            start = omp_get_wtime();
+            hll_mp_parallel_mat_per_vec(hll_mp, x, z);
+            end = omp_get_wtime();
+            time_hll_mp += end - start;
+        }
+        report_accuracy("HLL float/delta16", y, z, csr->M);
+
+        printf("\u2705 Tempo medio CSR precisione mista per %s: %.6lf s (%.2f byte/nz)\n", entry->d_name,
+               time_csr_mp / COMPUTATION_NUMBER, csr_mp_bytes_per_nz(csr_mp));
+        printf("\u2705 Tempo medio HLL precisione mista per %s: %.6lf s (%.2f byte/nz)\n", entry->d_name,
+               time_hll_mp / COMPUTATION_NUMBER, hll_mp_bytes_per_nz(hll_mp));
+        free_csr_mp_matrix(csr_mp);
+        free_hll_mp_matrix(hll_mp);
+
+        // Stream di indici compatto: blocchi stencil rigenerati come base + stride
+        HLLCompactIndex* hll_index = hll_build_compact_index(hll, csr);
+        double time_hll_compact = 0.0;
+
+        for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+            start = omp_get_wtime();
+            hll_compact_parallel_mat_per_vec(hll, hll_index, x, z);
+            end = omp_get_wtime();
+            time_hll_compact += end - start;
+        }
+        if (!compute_norm(y, z, csr->M, 1e-4)) {
+            printf("\u274c Differenza nei risultati CSR vs HLL indici compatti per %s\n", entry->d_name);
+        }
+        printf("\u2705 Tempo medio HLL indici compatti per %s: %.6lf s (%d/%d blocchi compatti, indici %lld/%lld)\n",
+               entry->d_name, time_hll_compact / COMPUTATION_NUMBER, hll_index->compact_blocks,
+               hll_index->num_blocks, hll_index->data_len, (long long)hll->hack_offset[hll->num_blocks]);
+        free_hll_compact_index(hll_index);
+
+        // File simmetrici: solo triangolo inferiore, circa metà del traffico sulla matrice;
+        // estratto dalla CSR già in memoria, senza rileggere il file
+        CSRSymMatrix* sym = symmetric ? convert_csr_to_sym(csr, 0) : NULL;
+        if (sym) {
+            double time_sym = 0.0;
+            for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+                start = omp_get_wtime();
+                csr_sym_parallel_mat_per_vec(sym, x, z);
+                end = omp_get_wtime();
+                time_sym += end - start;
+            }
+            if (!compute_norm(y, z, csr->M, 1e-4)) {
+                printf("\u274c Differenza nei risultati CSR vs simmetrica per %s\n", entry->d_name);
+            }
+            printf("\u2705 Tempo medio CSR simmetrica per %s: %.6lf s (%d nz memorizzati su %d)\n",
+                   entry->d_name, time_sym / COMPUTATION_NUMBER, sym->lower.NZ, csr->NZ);
+            free_sym_matrix(sym);
+        }
+
+        // BCSR solo se un blocco denso riduce il traffico stimato rispetto alla CSR
+        const int block_r = features.bcsr_r, block_c = features.bcsr_c;
+        const double block_fill = features.bcsr_fill_ratio;
+        if (block_r * block_c > 1) {
+            BCSRMatrix* bcsr = convert_csr_to_bcsr(csr, block_r, block_c);
+            double time_bcsr = 0.0;
+            for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+                start = omp_get_wtime();
+                bcsr_parallel_mat_per_vec(bcsr, x, z);
+                end = omp_get_wtime();
+                time_bcsr += end - start;
+            }
+            if (!compute_norm(y, z, csr->M, 1e-4)) {
+                printf("\u274c Differenza nei risultati CSR vs BCSR per %s\n", entry->d_name);
+            }
+            printf("\u2705 Tempo medio BCSR %dx%d per %s: %.6lf s (fill ratio %.3f)\n",
+                   block_r, block_c, entry->d_name, time_bcsr / COMPUTATION_NUMBER, block_fill);
+            free_bcsr_matrix(bcsr);
+        }
+
+        // DIA solo se le diagonali occupate non gonfiano troppo i valori memorizzati
+        DIAMatrix* dia = convert_csr_to_dia(csr, DIA_MAX_FILL);
+        if (dia) {
+            double time_dia = 0.0;
+            for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+                start = omp_get_wtime();
+                dia_parallel_mat_per_vec(dia, x, z);
+                end = omp_get_wtime();
+                time_dia += end - start;
+            }
+            if (!compute_norm(y, z, csr->M, 1e-4)) {
+                printf("\u274c Differenza nei risultati CSR vs DIA per %s\n", entry->d_name);
+            }
+            printf("\u2705 Tempo medio DIA per %s: %.6lf s (%d diagonali)\n",
+                   entry->d_name, time_dia / COMPUTATION_NUMBER, dia->num_diags);
+            free_dia_matrix(dia);
+        }
+
+        HYBMatrix* hyb = convert_csr_to_hyb(csr, 0);
+        double time_hyb = 0.0;
+        for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+            start = omp_get_wtime();
+            hyb_parallel_mat_per_vec(hyb, x, z);
+            end = omp_get_wtime();
+            time_hyb += end - start;
+        }
+        if (!compute_norm(y, z, csr->M, 1e-4)) {
+            printf("\u274c Differenza nei risultati CSR vs HYB per %s\n", entry->d_name);
+        }
+        printf("\u2705 Tempo medio HYB per %s: %.6lf s (ELL %d per riga, %d elementi COO)\n",
+               entry->d_name, time_hyb / COMPUTATION_NUMBER, hyb->ell_width, hyb->coo_nz);
+        free_hyb_matrix(hyb);
+
+        // CSR a pannelli solo se x non entra in un pannello e i pannelli non sono troppo radi
+        CSRTiledMatrix* tiled = csr->N > panel_width ? convert_csr_to_tiled(csr, panel_width, 0) : NULL;
+        if (tiled) {
+            double time_tiled = 0.0;
+            for (int i = 0; i < COMPUTATION_NUMBER; i++) {
+                start = omp_get_wtime();
+                csr_tiled_parallel_mat_per_vec(tiled, x, z);
+                end = omp_get_wtime();
+                time_tiled += end - start;
+            }
+            if (!compute_norm(y, z, csr->M, 1e-4)) {
+                printf("\u274c Differenza nei risultati CSR vs CSR a pannelli per %s\n", entry->d_name);
+            }
+            printf("\u2705 Tempo medio CSR a pannelli per %s: %.6lf s (%d pannelli da %d colonne, %d righe memorizzate)\n",
+                   entry->d_name, time_tiled / COMPUTATION_NUMBER, tiled->num_panels, tiled->panel_width, tiled->num_rows);
+            free_tiled_matrix(tiled);
+        }
+
+        // Solutori sul piano scelto: b = A x, quindi la soluzione esatta è x
+        SolverWorkspace* ws = solve ? solver_workspace_create(plan) : NULL;
+        if (ws) {
+            SolverStats stats;
+            double* sol = spmv_malloc(csr->M * sizeof(double));
+
+            memset(sol, 0, csr->M * sizeof(double));
+            solver_cg(ws, y, sol, SOLVER_TOLERANCE, SOLVER_MAX_ITERATIONS, &stats);
+            solver_print_stats("CG", &stats);
+            if (stats.converged && !compute_norm(x, sol, csr->M, 1e-4)) {
+                printf("\u274c Differenza tra soluzione CG e vettore atteso per %s\n", entry->d_name);
+            }
+
+            // Jacobi solo se la diagonale domina abbastanza righe da ridurre le iterazioni
+            if (choice.jacobi) {
+                memset(sol, 0, csr->M * sizeof(double));
+                solver_pcg_jacobi(ws, y, sol, SOLVER_TOLERANCE, SOLVER_MAX_ITERATIONS, &stats);
+                solver_print_stats("PCG Jacobi", &stats);
+                if (stats.converged && !compute_norm(x, sol, csr->M, 1e-4)) {
+                    printf("\u274c Differenza tra soluzione PCG e vettore atteso per %s\n", entry->d_name);
+                }
+            } else {
+                printf("PCG Jacobi saltato: diagonale dominante solo nel %.1f%% delle righe\n",
+                       100.0 * features.diag_dominance);
+            }
+
+            for (int i = 0; i < csr->M; i++) sol[i] = 1.0;
+            solver_power_iteration(ws, sol, SOLVER_TOLERANCE, SOLVER_MAX_ITERATIONS, &stats);
+            solver_print_stats("Metodo delle potenze", &stats);
+
+            spmv_free(sol);
+            solver_workspace_destroy(ws);
+        }
 
         // Cleanup
-        free(x); free(y); free(z);
-        free_csr_matrix(csr);
-        free_hll_matrix(hll);
+        spmv_free(x); spmv_free(y); spmv_free(z);
+        spmv_plan_destroy(plan);
+        free_reordering(rcm);
+        if (cache) {
+            matrix_cache_close(cache);
+        } else {
+            free_csr_matrix(csr);
+            free_hll_matrix(hll);
+        }
+        arena_reset(arena);
     }
 
     closedir(dir);
+    spmv_set_arena(NULL);
+    arena_destroy(arena);
     return EXIT_SUCCESS;
 }
 
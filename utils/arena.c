@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "include/arena.h"
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static inline size_t round_up(size_t v, size_t a) {
+    return (v + a - 1) / a * a;
+}
+
+// Mappa anonima di size byte con inizio allineato a ARENA_HUGE_PAGE: il
+// kernel usa pagine THP solo per regioni da 2 MB allineate
+static void* map_huge_aligned(size_t size) {
+    size_t span = size + ARENA_HUGE_PAGE;
+    char* raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return MAP_FAILED;
+
+    char* base = (char*)round_up((size_t)raw, ARENA_HUGE_PAGE);
+    if (base > raw) munmap(raw, base - raw);
+    if (raw + span > base + size) munmap(base + size, raw + span - (base + size));
+    return base;
+}
+
+static ArenaChunk* chunk_create(size_t size, ArenaPages pages) {
+    size = round_up(size, ARENA_HUGE_PAGE);
+    void* base = MAP_FAILED;
+
+    if (pages == ARENA_PAGES_HUGE) {
+#ifdef MAP_HUGETLB
+        // Pagine huge esplicite: richiedono hugetlbfs configurato, altrimenti si ripiega su THP
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (base == MAP_FAILED) {
+            base = map_huge_aligned(size);
+#ifdef MADV_HUGEPAGE
+            if (base != MAP_FAILED) madvise(base, size, MADV_HUGEPAGE);
+#endif
+        }
+    } else {
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_NOHUGEPAGE
+        if (base != MAP_FAILED && pages == ARENA_PAGES_SMALL) madvise(base, size, MADV_NOHUGEPAGE);
+#endif
+    }
+    if (base == MAP_FAILED) return NULL;
+
+    ArenaChunk* chunk = malloc(sizeof(ArenaChunk));
+    if (!chunk) {
+        munmap(base, size);
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->base = base;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+static void chunk_destroy(ArenaChunk* chunk) {
+    munmap(chunk->base, chunk->size);
+    free(chunk);
+}
+
+Arena* arena_create(size_t chunk_size, ArenaPages pages) {
+    Arena* arena = malloc(sizeof(Arena));
+    safe_malloc_check(arena, "malloc Arena");
+    arena->chunks = NULL;
+    arena->chunk_size = chunk_size > 0 ? chunk_size : ARENA_DEFAULT_CHUNK;
+    arena->pages = pages;
+    arena->allocated = 0;
+    arena->peak = 0;
+    arena->fresh_pages = 0;
+    return arena;
+}
+
+void* arena_alloc(Arena* arena, size_t bytes) {
+    bytes = round_up(bytes > 0 ? bytes : 1, ARENA_ALIGNMENT);
+    void* ptr = NULL;
+
+    #pragma omp critical(arena_alloc)
+    {
+        ArenaChunk* chunk = arena->chunks;
+        if (!chunk || chunk->used + bytes > chunk->size) {
+            chunk = chunk_create(bytes > arena->chunk_size ? bytes : arena->chunk_size, arena->pages);
+            if (chunk) {
+                chunk->next = arena->chunks;
+                arena->chunks = chunk;
+            }
+        }
+        if (chunk) {
+            ptr = chunk->base + chunk->used;
+            chunk->used += bytes;
+            arena->allocated += bytes;
+            if (arena->allocated > arena->peak) arena->peak = arena->allocated;
+        }
+    }
+
+    safe_malloc_check(ptr, "arena_alloc");
+    return ptr;
+}
+
+void arena_reset(Arena* arena) {
+    if (!arena->chunks) return;
+
+    // Più chunk: si sostituiscono con uno solo dimensionato sul picco
+    if (arena->chunks->next) {
+        while (arena->chunks) {
+            ArenaChunk* next = arena->chunks->next;
+            chunk_destroy(arena->chunks);
+            arena->chunks = next;
+        }
+        size_t size = arena->peak > arena->chunk_size ? arena->peak : arena->chunk_size;
+        arena->chunks = chunk_create(size, arena->pages);
+    } else {
+        // MADV_DONTNEED su memoria anonima privata: il prossimo accesso
+        // trova pagine azzerate, allocate sul nodo del thread che le tocca
+        if (arena->fresh_pages) madvise(arena->chunks->base, arena->chunks->size, MADV_DONTNEED);
+        arena->chunks->used = 0;
+    }
+    arena->allocated = 0;
+}
+
+void arena_set_fresh_pages(Arena* arena, int enable) {
+    arena->fresh_pages = enable;
+}
+
+void arena_destroy(Arena* arena) {
+    if (!arena) return;
+    while (arena->chunks) {
+        ArenaChunk* next = arena->chunks->next;
+        chunk_destroy(arena->chunks);
+        arena->chunks = next;
+    }
+    free(arena);
+}
+
+static Arena* current_arena = NULL;
+
+void spmv_set_arena(Arena* arena) {
+    current_arena = arena;
+}
+
+Arena* spmv_get_arena(void) {
+    return current_arena;
+}
+
+void* spmv_malloc(size_t bytes) {
+    if (current_arena) return arena_alloc(current_arena, bytes);
+    return spmv_malloc_heap(bytes);
+}
+
+void* spmv_malloc_heap(size_t bytes) {
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, ARENA_ALIGNMENT, bytes > 0 ? bytes : ARENA_ALIGNMENT) != 0) ptr = NULL;
+    return ptr;
+}
+
+void* spmv_calloc(size_t count, size_t size) {
+    void* ptr = spmv_malloc(count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void spmv_free(void* ptr) {
+    if (!ptr) return;
+    if (current_arena) {
+        for (ArenaChunk* c = current_arena->chunks; c; c = c->next) {
+            if ((char*)ptr >= c->base && (char*)ptr < c->base + c->size) return;
+        }
+    }
+    free(ptr);
+}
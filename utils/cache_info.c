@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "include/cache_info.h"
+
+#define CACHE_SYSFS_DIR "/sys/devices/system/cpu/cpu0/cache"
+
+// Prima riga del file path in buf (senza '\n'); 0 se il file non esiste
+static int read_sysfs_line(const char* path, char* buf, size_t len) {
+    FILE* f = fopen(path, "r");
+    if (!f) return 0;
+    int ok = fgets(buf, (int)len, f) != NULL;
+    fclose(f);
+    if (ok) buf[strcspn(buf, "\n")] = '\0';
+    return ok;
+}
+
+// "32768K", "8M", "1G" o un numero di byte senza suffisso
+static size_t parse_cache_size(const char* s) {
+    char* end;
+    unsigned long long value = strtoull(s, &end, 10);
+    switch (*end) {
+        case 'K': case 'k': return (size_t)value << 10;
+        case 'M': case 'm': return (size_t)value << 20;
+        case 'G': case 'g': return (size_t)value << 30;
+        default:            return (size_t)value;
+    }
+}
+
+size_t detect_llc_size(void) {
+    char path[256], buf[64];
+    int best_level = 0;
+    size_t best_size = 0;
+
+    // index0, index1, ... fino al primo mancante; la cache istruzioni non conta
+    for (int idx = 0;; idx++) {
+        snprintf(path, sizeof(path), CACHE_SYSFS_DIR "/index%d/level", idx);
+        if (!read_sysfs_line(path, buf, sizeof(buf))) break;
+        int level = atoi(buf);
+
+        snprintf(path, sizeof(path), CACHE_SYSFS_DIR "/index%d/type", idx);
+        if (read_sysfs_line(path, buf, sizeof(buf)) && strcmp(buf, "Instruction") == 0) continue;
+
+        snprintf(path, sizeof(path), CACHE_SYSFS_DIR "/index%d/size", idx);
+        if (!read_sysfs_line(path, buf, sizeof(buf))) continue;
+        size_t size = parse_cache_size(buf);
+
+        if (level > best_level || (level == best_level && size > best_size)) {
+            best_level = level;
+            best_size = size;
+        }
+    }
+    if (best_size > 0) return best_size;
+
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (l3 > 0) return (size_t)l3;
+#endif
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (l2 > 0) return (size_t)l2;
+#endif
+    return LLC_DEFAULT_BYTES;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "include/hugepage.h"
+
+#define SMAPS_LINE_LENGTH 512
+
+int query_page_usage(const void* ptr, size_t bytes, PageUsage* usage) {
+    memset(usage, 0, sizeof(PageUsage));
+
+    FILE* f = fopen("/proc/self/smaps", "r");
+    if (!f) {
+        perror("Error opening /proc/self/smaps");
+        return -1;
+    }
+
+    const uintptr_t begin = (uintptr_t)ptr;
+    const uintptr_t end = begin + (bytes > 0 ? bytes : 1);
+    char line[SMAPS_LINE_LENGTH];
+    int inside = 0, found = 0;
+
+    // Ogni VMA inizia con "start-end perm ..."; seguono righe "Campo: valore kB"
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long lo, hi;
+        size_t kb;
+        if (sscanf(line, "%lx-%lx ", &lo, &hi) == 2) {
+            inside = lo < end && hi > begin;
+            found |= inside;
+        } else if (!inside) {
+            continue;
+        } else if (sscanf(line, "KernelPageSize: %zu kB", &kb) == 1) {
+            if (kb > usage->kernel_page_kb) usage->kernel_page_kb = kb;
+        } else if (sscanf(line, "Rss: %zu kB", &kb) == 1) {
+            usage->rss_kb += kb;
+        } else if (sscanf(line, "AnonHugePages: %zu kB", &kb) == 1 ||
+                   sscanf(line, "Private_Hugetlb: %zu kB", &kb) == 1 ||
+                   sscanf(line, "Shared_Hugetlb: %zu kB", &kb) == 1) {
+            usage->huge_kb += kb;
+        }
+    }
+
+    fclose(f);
+    return found ? 0 : -1;
+}
+
+void hugepage_report(const char* label, const void* ptr, size_t bytes) {
+    PageUsage u;
+    if (query_page_usage(ptr, bytes, &u) != 0) {
+        printf("Pagine %s: VMA non trovata\n", label);
+        return;
+    }
+
+    // Le pagine hugetlbfs non compaiono in Rss: si usa il massimo dei due
+    size_t resident = u.rss_kb > u.huge_kb ? u.rss_kb : u.huge_kb;
+    printf("Pagine %s: pagina kernel %zu KB, residenti %.1f MB, in pagine da 2 MB %.1f%%\n",
+           label, u.kernel_page_kb, resident / 1024.0, resident ? 100.0 * u.huge_kb / resident : 0.0);
+}
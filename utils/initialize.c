@@ -9,6 +9,7 @@
 #include "include/mmio.h"
 #include "include/CSR_Matrix.h"
 #include "include/HLL_Matrix.h"
+#include "include/arena.h"
 
 double *initialize_x_vector(int size)
 {
@@ -17,7 +18,7 @@ double *initialize_x_vector(int size)
     srand(time(NULL));
 
     // Create x vector
-    double *x = (double *)calloc(size, sizeof(double));
+    double *x = (double *)spmv_calloc(size, sizeof(double));
     if (x == NULL)
     {
         printf("Error occur in malloc for the x vector!\nError code: %d\n", errno);
@@ -33,7 +34,7 @@ double *initialize_x_vector(int size)
 
 double *initialize_y_vector(int size)
 {
-    double *y = (double *)calloc(size, sizeof(double));
+    double *y = (double *)spmv_calloc(size, sizeof(double));
     if (y == NULL)
     {
         printf("Error occour in malloc for the y vector!\n Error code: %d\n", errno);
@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/matrix_cache.h"
+
+#define CACHE_ALIGNMENT 64
+
+static inline uint64_t align_up(uint64_t v) {
+    return (v + CACHE_ALIGNMENT - 1) & ~(uint64_t)(CACHE_ALIGNMENT - 1);
+}
+
+static int write_section(FILE* f, uint64_t offset, const void* data, size_t bytes) {
+    if (fseek(f, (long)offset, SEEK_SET) != 0) return -1;
+    if (bytes > 0 && fwrite(data, 1, bytes, f) != bytes) return -1;
+    return 0;
+}
+
+int matrix_cache_store(const char* cache_path, const char* source_path,
+                       const CSRMatrix* csr, const HLLMatrix* hll) {
+    struct stat st;
+    if (stat(source_path, &st) != 0) {
+        perror("Error reading source file");
+        return -1;
+    }
+
+    MatrixCacheHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, MATRIX_CACHE_MAGIC, sizeof(MATRIX_CACHE_MAGIC));
+    h.version = MATRIX_CACHE_VERSION;
+    h.header_size = sizeof(MatrixCacheHeader);
+    h.source_size = (uint64_t)st.st_size;
+    h.source_mtime_sec = st.st_mtim.tv_sec;
+    h.source_mtime_nsec = st.st_mtim.tv_nsec;
+    h.M = csr->M;
+    h.N = csr->N;
+    h.NZ = csr->NZ;
+    h.hack_size = hll->HackSize;
+    h.num_blocks = hll->num_blocks;
+
+    uint64_t hll_elems = (uint64_t)hll->hack_offset[hll->num_blocks];
+
+    h.irp_offset = align_up(sizeof(MatrixCacheHeader));
+    h.ja_offset = align_up(h.irp_offset + (uint64_t)(csr->M + 1) * sizeof(int));
+    h.as_offset = align_up(h.ja_offset + (uint64_t)csr->NZ * sizeof(int));
+    h.hack_offset_offset = align_up(h.as_offset + (uint64_t)csr->NZ * sizeof(double));
+    h.hll_ja_offset = align_up(h.hack_offset_offset + (uint64_t)(hll->num_blocks + 1) * sizeof(int64_t));
+    h.hll_as_offset = align_up(h.hll_ja_offset + hll_elems * sizeof(int));
+    h.file_size = h.hll_as_offset + hll_elems * sizeof(double);
+    if (hll->perm) {
+        h.perm_offset = align_up(h.file_size);
+        h.file_size = h.perm_offset + (uint64_t)hll->M * sizeof(int);
+    }
+
+    // Scrittura su file temporaneo + rename, così un lettore concorrente
+    // non vede mai una cache scritta a metà
+    size_t tmp_len = strlen(cache_path) + 5;
+    char* tmp_path = malloc(tmp_len);
+    if (!tmp_path) {
+        perror("malloc cache path");
+        return -1;
+    }
+    snprintf(tmp_path, tmp_len, "%s.tmp", cache_path);
+
+    FILE* f = fopen(tmp_path, "wb");
+    if (!f) {
+        perror("Error creating cache file");
+        free(tmp_path);
+        return -1;
+    }
+
+    int err = write_section(f, 0, &h, sizeof(h));
+    err |= write_section(f, h.irp_offset, csr->IRP, (size_t)(csr->M + 1) * sizeof(int));
+    err |= write_section(f, h.ja_offset, csr->JA, (size_t)csr->NZ * sizeof(int));
+    err |= write_section(f, h.as_offset, csr->AS, (size_t)csr->NZ * sizeof(double));
+    err |= write_section(f, h.hack_offset_offset, hll->hack_offset, (size_t)(hll->num_blocks + 1) * sizeof(int64_t));
+    err |= write_section(f, h.hll_ja_offset, hll->JA, hll_elems * sizeof(int));
+    err |= write_section(f, h.hll_as_offset, hll->AS, hll_elems * sizeof(double));
+    if (hll->perm) err |= write_section(f, h.perm_offset, hll->perm, (size_t)hll->M * sizeof(int));
+    // Garantisce che il file raggiunga file_size anche se l'ultima sezione è vuota
+    if (!err && ftruncate(fileno(f), (off_t)h.file_size) != 0) err = -1;
+    if (fclose(f) != 0) err = -1;
+
+    if (!err && rename(tmp_path, cache_path) != 0) err = -1;
+    if (err) {
+        perror("Error writing cache file");
+        unlink(tmp_path);
+    }
+
+    free(tmp_path);
+    return err ? -1 : 0;
+}
+
+MatrixCache* matrix_cache_open(const char* cache_path, const char* source_path, int hack_size) {
+    struct stat src, st;
+    if (stat(source_path, &src) != 0) return NULL;
+
+    int fd = open(cache_path, O_RDONLY);
+    if (fd < 0) return NULL;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(MatrixCacheHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t map_size = (size_t)st.st_size;
+    char* map = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    const MatrixCacheHeader* h = (const MatrixCacheHeader*)map;
+
+    // Controllo di versione e di staleness rispetto al sorgente
+    int valid = memcmp(h->magic, MATRIX_CACHE_MAGIC, sizeof(MATRIX_CACHE_MAGIC)) == 0 &&
+                h->version == MATRIX_CACHE_VERSION &&
+                h->header_size == sizeof(MatrixCacheHeader) &&
+                h->file_size == map_size &&
+                h->source_size == (uint64_t)src.st_size &&
+                h->source_mtime_sec == src.st_mtim.tv_sec &&
+                h->source_mtime_nsec == src.st_mtim.tv_nsec &&
+                h->hack_size == hack_size;
+    if (!valid) {
+        munmap(map, map_size);
+        return NULL;
+    }
+
+    MatrixCache* cache = malloc(sizeof(MatrixCache));
+    HLLBlock* blocks = malloc((size_t)h->num_blocks * sizeof(HLLBlock) + 1);
+    if (!cache || !blocks) {
+        perror("malloc MatrixCache");
+        free(cache);
+        free(blocks);
+        munmap(map, map_size);
+        return NULL;
+    }
+
+    cache->map = map;
+    cache->map_size = map_size;
+
+    cache->csr.M = h->M;
+    cache->csr.N = h->N;
+    cache->csr.NZ = h->NZ;
+    cache->csr.IRP = (int*)(map + h->irp_offset);
+    cache->csr.JA = (int*)(map + h->ja_offset);
+    cache->csr.AS = (double*)(map + h->as_offset);
+
+    int64_t* hack_offset = (int64_t*)(map + h->hack_offset_offset);
+    int* hll_ja = (int*)(map + h->hll_ja_offset);
+    double* hll_as = (double*)(map + h->hll_as_offset);
+
+    // I descrittori dei blocchi si ricavano da hack_offset senza copiare dati
+    for (int b = 0; b < h->num_blocks; ++b) {
+        int start = b * h->hack_size;
+        int rows_in_block = (start + h->hack_size <= h->M) ? h->hack_size : h->M - start;
+        blocks[b].rows_in_block = rows_in_block;
+        blocks[b].max_nz_per_row = (int)((hack_offset[b + 1] - hack_offset[b]) / rows_in_block);
+        blocks[b].JA = hll_ja + hack_offset[b];
+        blocks[b].AS = hll_as + hack_offset[b];
+    }
+
+    cache->hll.M = h->M;
+    cache->hll.N = h->N;
+    cache->hll.NZ = h->NZ;
+    cache->hll.HackSize = h->hack_size;
+    cache->hll.num_blocks = h->num_blocks;
+    cache->hll.blocks = blocks;
+    cache->hll.hack_offset = hack_offset;
+    cache->hll.JA = hll_ja;
+    cache->hll.AS = hll_as;
+    cache->hll.perm = h->perm_offset ? (int*)(map + h->perm_offset) : NULL;
+
+    return cache;
+}
+
+void matrix_cache_close(MatrixCache* cache) {
+    if (!cache) return;
+    free(cache->hll.blocks);
+    munmap(cache->map, cache->map_size);
+    free(cache);
+}
@@ -0,0 +1,157 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <omp.h>
+
+#include "include/CSR_Matrix.h"
+#include "include/HLL_Matrix.h"
+#include "include/numa_alloc.h"
+#include "include/arena.h"
+
+#define NUMA_MAX_NODES 64
+#define NUMA_REPORT_MAX_PAGES 4096
+
+static inline void safe_malloc_check(void* ptr, const char* msg) {
+    if (!ptr) {
+        perror(msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+int numa_pin_threads(void) {
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+        perror("sched_getaffinity");
+        return -1;
+    }
+
+    int cpus[CPU_SETSIZE];
+    int ncpus = 0;
+    for (int c = 0; c < CPU_SETSIZE; ++c) {
+        if (CPU_ISSET(c, &mask)) cpus[ncpus++] = c;
+    }
+    if (ncpus == 0) return -1;
+
+    int pinned = 0;
+    #pragma omp parallel reduction(+:pinned)
+    {
+        cpu_set_t own;
+        CPU_ZERO(&own);
+        CPU_SET(cpus[omp_get_thread_num() % ncpus], &own);
+        // pid 0: il thread chiamante, non l'intero processo
+        if (sched_setaffinity(0, sizeof(own), &own) == 0) pinned++;
+    }
+    return pinned;
+}
+
+double* numa_alloc_vector(int size, const int* row_start, int nthreads) {
+    double* v = spmv_malloc((size_t)size * sizeof(double));
+    safe_malloc_check(v, "malloc NUMA vector");
+
+    #pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+    for (int t = 0; t < nthreads; ++t) {
+        memset(v + row_start[t], 0, (size_t)(row_start[t + 1] - row_start[t]) * sizeof(double));
+    }
+    return v;
+}
+
+void numa_place_csr(CSRMatrix* csr, const int* row_start, int nthreads) {
+    // Fuori dall'arena: i buffer sostituiti non si possono restituire fino al reset
+    int* IRP = spmv_malloc_heap((csr->M + 1) * sizeof(int));
+    int* JA = spmv_malloc_heap((size_t)csr->NZ * sizeof(int));
+    double* AS = spmv_malloc_heap((size_t)csr->NZ * sizeof(double));
+    safe_malloc_check(IRP, "malloc NUMA IRP");
+    safe_malloc_check(JA, "malloc NUMA JA");
+    safe_malloc_check(AS, "malloc NUMA AS");
+
+    #pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+    for (int t = 0; t < nthreads; ++t) {
+        int rb = row_start[t], re = row_start[t + 1];
+        int nb = csr->IRP[rb], ne = csr->IRP[re];
+        memcpy(IRP + rb, csr->IRP + rb, (size_t)(re - rb + (t == nthreads - 1)) * sizeof(int));
+        memcpy(JA + nb, csr->JA + nb, (size_t)(ne - nb) * sizeof(int));
+        memcpy(AS + nb, csr->AS + nb, (size_t)(ne - nb) * sizeof(double));
+    }
+
+    spmv_free(csr->IRP);
+    spmv_free(csr->JA);
+    spmv_free(csr->AS);
+    csr->IRP = IRP;
+    csr->JA = JA;
+    csr->AS = AS;
+}
+
+void numa_place_hll(HLLMatrix* hll, const int* block_start, int nthreads) {
+    size_t total = (size_t)hll->hack_offset[hll->num_blocks];
+    int* JA = spmv_malloc_heap(total * sizeof(int));
+    double* AS = spmv_malloc_heap(total * sizeof(double));
+    safe_malloc_check(JA, "malloc NUMA HLL JA");
+    safe_malloc_check(AS, "malloc NUMA HLL AS");
+
+    #pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+    for (int t = 0; t < nthreads; ++t) {
+        int64_t sb = hll->hack_offset[block_start[t]], se = hll->hack_offset[block_start[t + 1]];
+        memcpy(JA + sb, hll->JA + sb, (size_t)(se - sb) * sizeof(int));
+        memcpy(AS + sb, hll->AS + sb, (size_t)(se - sb) * sizeof(double));
+    }
+
+    spmv_free(hll->JA);
+    spmv_free(hll->AS);
+    hll->JA = JA;
+    hll->AS = AS;
+    for (int b = 0; b < hll->num_blocks; ++b) {
+        hll->blocks[b].JA = JA + hll->hack_offset[b];
+        hll->blocks[b].AS = AS + hll->hack_offset[b];
+    }
+}
+
+void numa_report_placement(const char* label, const void* ptr, size_t bytes) {
+#ifdef SYS_move_pages
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uintptr_t first = (uintptr_t)ptr & ~(uintptr_t)(page - 1);
+    size_t npages = ((uintptr_t)ptr + bytes - first + page - 1) / page;
+    if (bytes == 0 || npages == 0) return;
+
+    // Oltre NUMA_REPORT_MAX_PAGES pagine si campiona a passo costante
+    size_t count = npages < NUMA_REPORT_MAX_PAGES ? npages : NUMA_REPORT_MAX_PAGES;
+    void* pages[NUMA_REPORT_MAX_PAGES];
+    int status[NUMA_REPORT_MAX_PAGES];
+    for (size_t i = 0; i < count; ++i) {
+        pages[i] = (void*)(first + (i * npages / count) * page);
+    }
+
+    // nodes == NULL: move_pages non sposta nulla e restituisce il nodo di ogni pagina
+    if (syscall(SYS_move_pages, 0, (unsigned long)count, pages, NULL, status, 0) != 0) {
+        perror("move_pages");
+        return;
+    }
+
+    size_t per_node[NUMA_MAX_NODES] = { 0 };
+    size_t absent = 0;
+    int max_node = -1;
+    for (size_t i = 0; i < count; ++i) {
+        if (status[i] < 0 || status[i] >= NUMA_MAX_NODES) {
+            absent++;
+            continue;
+        }
+        per_node[status[i]]++;
+        if (status[i] > max_node) max_node = status[i];
+    }
+
+    printf("Pagine %s (%zu campionate su %zu):", label, count, npages);
+    for (int n = 0; n <= max_node; ++n) {
+        printf(" nodo %d %.1f%%", n, 100.0 * per_node[n] / count);
+    }
+    if (absent) printf(" non presenti %.1f%%", 100.0 * absent / count);
+    printf("\n");
+#else
+    (void)ptr;
+    (void)bytes;
+    printf("Pagine %s: move_pages non disponibile\n", label);
+#endif
+}
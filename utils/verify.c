@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdbool.h>
+#include <math.h>
 #include "include/CSR_Matrix.h"
 #include "include/HLL_Matrix.h"
 /**
@@ -89,3 +90,39 @@ bool verify_hll_matrix(const HLLMatrix* mat, bool verbose) {
 
     return true;
 }
+
+/**
+ * Confronta due vettori risultato.
+ *
+ * Restituisce 1 se ||v1 - v2||_2 <= tol * ||v1||_2 (o <= tol se v1 è nullo),
+ * 0 altrimenti.
+ */
+int compute_norm(const double *v1, const double *v2, int size, double tol) {
+    double diff = 0.0, ref = 0.0;
+    for (int i = 0; i < size; ++i) {
+        double d = v1[i] - v2[i];
+        diff += d * d;
+        ref += v1[i] * v1[i];
+    }
+    diff = sqrt(diff);
+    ref = sqrt(ref);
+    return ref > 0.0 ? diff <= tol * ref : diff <= tol;
+}
+
+/**
+ * Stampa l'errore di `y` rispetto al risultato di riferimento `ref`
+ * (tipicamente il CSR in doppia precisione): errore massimo assoluto,
+ * errore massimo relativo per componente ed errore relativo in norma 2.
+ */
+void report_accuracy(const char *label, const double *ref, const double *y, int size) {
+    double max_abs = 0.0, max_rel = 0.0, diff = 0.0, norm = 0.0;
+    for (int i = 0; i < size; ++i) {
+        double d = fabs(ref[i] - y[i]);
+        if (d > max_abs) max_abs = d;
+        if (ref[i] != 0.0 && d / fabs(ref[i]) > max_rel) max_rel = d / fabs(ref[i]);
+        diff += d * d;
+        norm += ref[i] * ref[i];
+    }
+    printf("Accuratezza %s: err. max ass. %.3e, err. max rel. %.3e, err. rel. norma 2 %.3e\n",
+           label, max_abs, max_rel, norm > 0.0 ? sqrt(diff / norm) : sqrt(diff));
+}